@@ -0,0 +1,281 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "checkpoint.h"
+#include "trace.h"
+
+static const std::string checkpoint_magic = "YASATCK1";
+
+namespace {
+
+// LEB128 varint encoding into a byte string
+class CheckpointEncoder {
+public:
+    void put(unsigned long long value){
+        while( value >= 0x80 ){
+            bytes += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        bytes += static_cast<char>(value);
+    }
+    void put_signed(long long value){
+        put((static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));
+    }
+    void put_lits(const std::vector<int>& lits){
+        put(lits.size());
+        for( auto lit : lits ) put_signed(lit);
+    }
+
+    std::string bytes;
+};
+
+class CheckpointDecoder {
+public:
+    explicit CheckpointDecoder(const std::string& bytes) : bytes(bytes), pos(0), ok(true) {}
+
+    unsigned long long get(){
+        unsigned long long value = 0;
+        for( int shift = 0; shift < 64; shift += 7 ){
+            if( pos >= bytes.size() ){
+                ok = false;
+                return 0;
+            }
+            unsigned char byte = bytes[pos++];
+            value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+            if( !(byte & 0x80) ) return value;
+        }
+        ok = false;
+        return 0;
+    }
+    long long get_signed(){
+        unsigned long long value = get();
+        return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+    }
+    bool get_lits(std::vector<int>& lits){
+        unsigned long long size = get();
+        if( size > bytes.size() - pos ) return ok = false; // each literal is one byte at least
+        lits.resize(size);
+        for( auto& lit : lits ) lit = get_signed();
+        return ok;
+    }
+    std::string get_string(std::size_t size){
+        if( size > bytes.size() - pos ){
+            ok = false;
+            return "";
+        }
+        pos += size;
+        return bytes.substr(pos - size, size);
+    }
+
+    const std::string& bytes;
+    std::size_t pos;
+    bool ok;
+};
+
+bool write_checkpoint(const std::string& path, const std::string& formula_key, const SatSolver& solver,
+                      const std::vector<LiteralDecideNode>& decision_literals, const long long stats[3]){
+    TRACE_SCOPE("write_checkpoint");
+
+    CheckpointEncoder encoder;
+    encoder.bytes = checkpoint_magic;
+    encoder.put(formula_key.size());
+    encoder.bytes += formula_key;
+
+    encoder.put(solver.max_var_index);
+    for( int i = 0; i < 3; i++ ) encoder.put(stats[i]);
+
+    encoder.put_lits(solver.root_units);
+    encoder.put(solver.all_clauses.size());
+    for( const auto& clause : solver.all_clauses ){
+        encoder.put_lits(clause);
+    }
+    encoder.put(solver.all_cardinalities.size());
+    for( const auto& constraint : solver.all_cardinalities ){
+        encoder.put(constraint.bound);
+        encoder.put_lits(constraint.lits);
+    }
+
+    encoder.put(decision_literals.size());
+    for( const auto& node : decision_literals ){
+        encoder.put_signed(node.value ? node.lit_number : -node.lit_number);
+        encoder.put(node.bt_state);
+    }
+    encoder.put_lits(solver.original_of_var);
+
+    // a reader never sees a partial checkpoint
+    std::string tmp_path = path + ".tmp";
+    FILE *out = std::fopen(tmp_path.c_str(), "wb");
+    if( out == NULL ) return false;
+    bool is_written = std::fwrite(encoder.bytes.data(), 1, encoder.bytes.size(), out) == encoder.bytes.size();
+    is_written = std::fclose(out) == 0 && is_written;
+    return is_written && std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+void position_stats(const SatSolver& solver, long long stats[3]){
+    /*
+     * statistics of the search loop position: resume_limited() imposes the last decision
+     * again and counts it, so when it is implied already (not the inverted decision after
+     * a conflict) its decision is taken back here. Propagations after a resume differ
+     * anyway, the watches of the rebuilt trail are not the same.
+     */
+    stats[0] = solver.decisions;
+    stats[1] = solver.propagations;
+    stats[2] = solver.conflicts;
+    if( !solver.decision_literals.empty() &&
+        solver.literals[solver.decision_literals.back().lit_number].value != BoolVal::NOT_ASSIGNED ){
+        stats[0] -= 1;
+    }
+}
+
+}
+
+bool save_checkpoint(const std::string& path, const std::string& formula_key, const SatSolver& solver){
+    long long stats[3];
+    position_stats(solver, stats);
+    return write_checkpoint(path, formula_key, solver, solver.decision_literals, stats);
+}
+
+bool load_checkpoint(const std::string& path, std::string& formula_key, SatSolver& solver){
+    std::ifstream in(path, std::ios::binary);
+    if( !in ) return false;
+    std::ostringstream content;
+    content << in.rdbuf();
+    std::string bytes = content.str();
+
+    CheckpointDecoder decoder(bytes);
+    if( decoder.get_string(checkpoint_magic.size()) != checkpoint_magic ) return false;
+    formula_key = decoder.get_string(decoder.get());
+
+    solver = SatSolver();
+    solver.max_var_index = decoder.get();
+    solver.decisions = decoder.get();
+    solver.propagations = decoder.get();
+    solver.conflicts = decoder.get();
+
+    decoder.get_lits(solver.root_units);
+    solver.all_clauses.resize(decoder.ok ? decoder.get() : 0);
+    for( auto& clause : solver.all_clauses ){
+        if( !decoder.get_lits(clause) ) return false;
+    }
+    solver.all_cardinalities.resize(decoder.ok ? decoder.get() : 0);
+    for( auto& constraint : solver.all_cardinalities ){
+        constraint.bound = decoder.get();
+        if( !decoder.get_lits(constraint.lits) ) return false;
+    }
+
+    unsigned long long decision_size = decoder.ok ? decoder.get() : 0;
+    for( unsigned long long i = 0; i < decision_size && decoder.ok; i++ ){
+        int lit = decoder.get_signed();
+        int bt_state = decoder.get();
+        solver.decision_literals.emplace_back(std::abs(lit), lit > 0, bt_state);
+    }
+    // renumbering, not in checkpoints without it
+    if( decoder.ok && decoder.pos < bytes.size() ){
+        decoder.get_lits(solver.original_of_var);
+    }
+    if( !decoder.ok ) return false;
+
+    // variables out of range would index out of literals[]
+    auto in_range = [&solver](int lit){ return lit != 0 && std::abs(lit) <= solver.max_var_index; };
+    for( auto lit : solver.root_units ) if( !in_range(lit) ) return false;
+    for( const auto& clause : solver.all_clauses ){
+        if( clause.size() < 2 ) return false;
+        for( auto lit : clause ) if( !in_range(lit) ) return false;
+    }
+    for( const auto& constraint : solver.all_cardinalities ){
+        for( auto lit : constraint.lits ) if( !in_range(lit) ) return false;
+    }
+    for( const auto& node : solver.decision_literals ){
+        if( !in_range(node.lit_number) ) return false;
+    }
+    if( !solver.original_of_var.empty() ){
+        if( static_cast<int>(solver.original_of_var.size()) != solver.max_var_index + 1 ) return false;
+        solver.var_of_original.assign(solver.max_var_index + 1, 0);
+        for( int var = 1; var <= solver.max_var_index; var++ ){
+            int original = solver.original_of_var[var];
+            if( !in_range(original) || original < 0 || solver.var_of_original[original] != 0 ) return false;
+            solver.var_of_original[original] = var;
+        }
+    }
+    return true;
+}
+
+// CheckpointWriter
+CheckpointWriter::CheckpointWriter(const std::string& path, const std::string& formula_key, double interval_seconds) :
+    path(path), formula_key(formula_key), interval_seconds(interval_seconds), requested(false), solver(nullptr),
+    stopped(false), has_snapshot(false), write_count(0), failure_count(0)
+{
+    writer = std::thread(&CheckpointWriter::run, this);
+}
+
+CheckpointWriter::~CheckpointWriter(){
+    stop();
+}
+
+void CheckpointWriter::stop(){
+    if( !writer.joinable() ) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    changed.notify_all();
+    writer.join();
+}
+
+void CheckpointWriter::attach(SatSolver& solver){
+    this->solver = &solver;
+    solver.set_checkpoint_hook(&requested, [this](const SatSolver& solver){ snapshot(solver); });
+}
+
+void CheckpointWriter::snapshot(const SatSolver& solver){
+    /* search loop: copy the position only, clauses are written by run() */
+    TRACE_SCOPE("checkpoint_snapshot");
+    requested = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        decision_literals = solver.decision_literals;
+        position_stats(solver, stats);
+        has_snapshot = true;
+    }
+    changed.notify_all();
+}
+
+void CheckpointWriter::run(){
+    trace_thread_name("checkpoint");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    auto next_request = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(interval_seconds));
+    while( 1 ){
+        if( has_snapshot ){
+            std::vector<LiteralDecideNode> position;
+            position.swap(decision_literals);
+            long long saved_stats[3] = { stats[0], stats[1], stats[2] };
+            has_snapshot = false;
+
+            lock.unlock();
+            bool is_written = write_checkpoint(path, formula_key, *solver, position, saved_stats);
+            if( !is_written ){
+                std::fprintf(stderr, "ERROR! Could not write checkpoint: %s\n", path.c_str());
+            }
+            lock.lock();
+            if( is_written ) write_count += 1;
+            else failure_count += 1;
+            continue;
+        }
+        if( stopped ) return;
+
+        if( interval_seconds <= 0 ){
+            changed.wait(lock);
+        }
+        else if( changed.wait_until(lock, next_request) == std::cv_status::timeout ){
+            requested = true;
+            next_request = std::chrono::steady_clock::now() +
+                           std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                               std::chrono::duration<double>(interval_seconds));
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sat_solver.h"
+
+// checkpoint of a running SatSolver::solve_limited()
+//
+// the search of SatSolver is chronological, so its position is the decision
+// stack (decision_literals with values and bt_state), the trail is rebuilt by
+// implying the decisions again. A checkpoint file holds
+//
+//   magic "YASATCK1", formula key (FormulaHash::hex() of the input)
+//   max_var_index, decisions, propagations, conflicts
+//   root_units, simplified clauses, cardinality constraints
+//   decision stack: variable, value and bt_state of each decision
+//   original variable of each variable, empty when not renumbered (SatSolver::set_reorder)
+//
+// all integers are LEB128 varints (signed ones zigzag encoded).
+//
+//   save_checkpoint(): write from the solver, to `path'.tmp and rename()
+//   load_checkpoint(): fill a new SatSolver, SatSolver::resume_limited() continues
+
+bool save_checkpoint(const std::string& path, const std::string& formula_key, const SatSolver& solver);
+bool load_checkpoint(const std::string& path, std::string& formula_key, SatSolver& solver);
+
+// CheckpointWriter: checkpoints in a background thread
+//
+// the search loop only copies the decision stack and statistics (SatSolver::set_checkpoint_hook),
+// clauses are read by the writer thread, they don't change during solve_limited()
+// (SatSolver::compact() leaves them alone while a checkpoint hook is set).
+// A checkpoint is requested every `interval_seconds' (0: never) and by request(),
+// which only sets an atomic flag, so it can be called from a signal handler.
+// stop() (or the destructor) writes the last snapshot and joins the thread,
+// it must run before the solver is changed or destroyed.
+class CheckpointWriter {
+public:
+    CheckpointWriter(const std::string& path, const std::string& formula_key, double interval_seconds);
+    ~CheckpointWriter();
+
+    void attach(SatSolver& solver);
+    void request() { requested = true; }
+    void stop();
+    long long written() const { return write_count; }   // successful writes
+    long long failed() const { return failure_count; }
+
+private:
+    void snapshot(const SatSolver& solver);
+    void run();
+
+    std::string path;
+    std::string formula_key;
+    double interval_seconds;
+
+    std::atomic<bool> requested;
+    const SatSolver* solver;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool stopped;
+    bool has_snapshot;
+    std::vector<LiteralDecideNode> decision_literals; // snapshot of the search loop
+    long long stats[3];
+    long long write_count;
+    long long failure_count;
+
+    std::thread writer;
+};
+
+#endif /* end of include guard: __CHECKPOINT_H__ */
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "config_selector.h"
+
+// trained by `tools/train_selector.py benchmarks' on benchmarks/SAT, benchmarks/UNSAT and benchmarks/m2_sample
+static const char* builtin_table =
+#include "selector_table.inc"
+;
+
+void SolverConfig::apply(SatSolver& solver) const {
+    solver.set_detect_at_most_one(detect_amo);
+    solver.set_engine(engine);
+}
+
+const std::vector<SolverConfig>& solver_configs(){
+    static const std::vector<SolverConfig> configs = {
+        { "dpll",      false, SearchEngine::DPLL      },
+        { "dpll-amo",  true,  SearchEngine::DPLL      },
+        { "lookahead", false, SearchEngine::LOOKAHEAD },
+    };
+    return configs;
+}
+
+const SolverConfig* find_solver_config(const std::string& name){
+    for( const auto& config : solver_configs() ){
+        if( config.name == name ) return &config;
+    }
+    return nullptr;
+}
+
+ConfigSelector::ConfigSelector(){
+    std::istringstream table(builtin_table);
+    read_table(table);
+}
+
+bool ConfigSelector::load_table(const std::string& table_file){
+    std::ifstream table(table_file);
+    if( !table ) return false;
+
+    rows.clear();
+    read_table(table);
+    return !rows.empty();
+}
+
+void ConfigSelector::read_table(std::istream& table){
+    std::string line;
+    while( std::getline(table, line) ){
+        std::istringstream tokens(line);
+        std::string name;
+        if( !(tokens >> name) || name[0] == '#' ) continue;
+
+        // rows of unknown configurations are skipped
+        const SolverConfig* config = find_solver_config(name);
+        if( config == nullptr ) continue;
+
+        TableRow row;
+        row.config = config;
+        double value;
+        while( tokens >> value ){
+            row.features.push_back(std::log1p(std::max(value, 0.0)));
+        }
+        rows.push_back(row);
+    }
+}
+
+const SolverConfig& ConfigSelector::select(const std::vector<double>& features, double& distance) const {
+    const SolverConfig* best = &solver_configs()[0];
+    distance = std::numeric_limits<double>::infinity();
+
+    for( const auto& row : rows ){
+        if( row.features.size() != features.size() ) continue;
+
+        double row_distance = 0;
+        for( std::size_t i = 0; i < features.size(); i++ ){
+            double diff = row.features[i] - std::log1p(std::max(features[i], 0.0));
+            row_distance += diff * diff;
+        }
+        row_distance = std::sqrt(row_distance);
+
+        if( row_distance < distance ){
+            distance = row_distance;
+            best = row.config;
+        }
+    }
+    return *best;
+}
@@ -0,0 +1,48 @@
+#ifndef __CONFIG_SELECTOR_H__
+#define __CONFIG_SELECTOR_H__
+
+#include <string>
+#include <vector>
+
+#include "sat_solver.h"
+
+// SolverConfig: one named set of solver options
+struct SolverConfig {
+    std::string name;
+    bool detect_amo;
+    SearchEngine engine;
+
+    void apply(SatSolver& solver) const;
+};
+
+const std::vector<SolverConfig>& solver_configs();
+const SolverConfig* find_solver_config(const std::string& name);
+
+// ConfigSelector
+//
+// nearest neighbour over InstanceFeatures::values(): the configuration of the
+// training instance with the closest features (log scaled) is selected.
+//
+// table is trained offline by tools/train_selector.py, one training instance per line:
+//
+//   <config name> <feature 1> ... <feature n>
+//
+// the built-in table is used unless load_table() is called.
+class ConfigSelector {
+public:
+    ConfigSelector();
+
+    bool load_table(const std::string& table_file);
+    const SolverConfig& select(const std::vector<double>& features, double& distance) const;
+
+private:
+    void read_table(std::istream& table);
+
+    struct TableRow {
+        const SolverConfig* config;
+        std::vector<double> features;
+    };
+    std::vector<TableRow> rows;
+};
+
+#endif /* end of include guard: __CONFIG_SELECTOR_H__ */
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "formula_hash.h"
+
+static unsigned long long mix64(unsigned long long z){
+    // splitmix64 finalizer
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// domains of the start values, a constraint never hashes as a clause
+static const unsigned long long clause_domain = 0;
+static const unsigned long long cardinality_domain = 0x43415244494E414CULL;
+
+void FormulaHash::clause(const std::vector<int>& lits){
+    // duplicated literals of a clause are the same clause
+    std::vector<int> sorted_lits(lits);
+    std::sort(sorted_lits.begin(), sorted_lits.end());
+    sorted_lits.erase(std::unique(sorted_lits.begin(), sorted_lits.end()), sorted_lits.end());
+    add_sorted(sorted_lits, clause_domain);
+}
+
+void FormulaHash::cardinality(const std::vector<int>& lits, int bound){
+    // not deduplicated, the solver counts a repeated literal once per occurrence.
+    // bound is zigzag encoded, so negative bounds are distinct too
+    std::vector<int> sorted_lits(lits);
+    std::sort(sorted_lits.begin(), sorted_lits.end());
+    unsigned long long zigzag_bound = (static_cast<unsigned long long>(bound) << 1) ^
+                                      static_cast<unsigned long long>(bound < 0 ? -1LL : 0LL);
+    add_sorted(sorted_lits, mix64(cardinality_domain ^ mix64(zigzag_bound)));
+}
+
+void FormulaHash::add_sorted(const std::vector<int>& lits, unsigned long long tag){
+    unsigned long long hash_a = mix64(tag ^ 0x9E3779B97F4A7C15ULL);
+    unsigned long long hash_b = mix64(tag + 0x632BE59BD9B4E019ULL);
+    for( auto lit : lits ){
+        unsigned long long value = static_cast<unsigned int>(lit);
+        hash_a = mix64(hash_a ^ value);
+        hash_b = mix64(hash_b + value * 0xD6E8FEB86659FD93ULL);
+    }
+
+    sum_a += hash_a;
+    sum_b += hash_b;
+    count += 1;
+}
+
+std::string FormulaHash::hex() const {
+    char buf[33];
+    std::snprintf(buf, sizeof(buf), "%016llx%016llx", sum_a ^ mix64(count), sum_b);
+    return buf;
+}
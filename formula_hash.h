@@ -0,0 +1,36 @@
+#ifndef __FORMULA_HASH_H__
+#define __FORMULA_HASH_H__
+
+#include <string>
+#include <vector>
+
+#include "parser.h"
+
+// FormulaHash
+//
+// 128 bit hash of the multiset of clauses (and cardinality constraints).
+// Literals of each clause are sorted and deduplicated before hashing, and
+// clause hashes are combined by addition, so the hash doesn't depend on
+// clause order, literal order or duplicated literals in a clause.
+// Cardinality constraints are sorted but keep repeated literals (each one
+// counts), and start from their own domain and the bound.
+// The hash function is fixed (no std::hash), so hashes can be stored on disk.
+// As a DIMACSSink, it can be computed while parsing.
+class FormulaHash : public DIMACSSink {
+public:
+    FormulaHash() : sum_a(0), sum_b(0), count(0) {}
+
+    void clause(const std::vector<int>& lits);
+    void cardinality(const std::vector<int>& lits, int bound);
+
+    std::string hex() const; // 32 hex digits
+
+private:
+    void add_sorted(const std::vector<int>& lits, unsigned long long tag);
+
+    unsigned long long sum_a;
+    unsigned long long sum_b;
+    unsigned long long count;
+};
+
+#endif /* end of include guard: __FORMULA_HASH_H__ */
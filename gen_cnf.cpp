@@ -0,0 +1,260 @@
+/*
+ * synthetic CNF generator for scaling studies
+ *
+ *   ./yasat_gen random  --vars N (--ratio R | --clauses M) [--k K]
+ *   ./yasat_gen planted --vars N (--ratio R | --clauses M) [--k K]
+ *   ./yasat_gen parity  --size D [--sat]
+ *   ./yasat_gen php     --holes N
+ *
+ *   common options: --seed S (default 1), -o output.cnf (default stdout)
+ *
+ * families:
+ *
+ *   random:  uniform random k-SAT, k distinct variables per clause.
+ *   planted: random k-SAT which is satisfied by a hidden assignment, always SAT.
+ *   parity:  dubois-style chain, 2D xor of 3 variables over 3D variables,
+ *            every variable is in exactly 2 xor, so odd total parity is UNSAT.
+ *            `--sat' makes total parity even.
+ *   php:     pigeonhole, N+1 pigeons in N holes, UNSAT.
+ *
+ * output only depends on arguments and seed, and is streamed through
+ * OutStreamBuffer, so hundreds of millions of clauses don't need memory.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define CHUNK_LIMIT 1048576
+
+class OutStreamBuffer {
+    FILE *out;
+    char  buf[CHUNK_LIMIT];
+    int   pos;
+
+    void assureSpace(int size) {
+        if (pos + size > CHUNK_LIMIT) flush(); }
+
+    public:
+    OutStreamBuffer(FILE *o) : out(o), pos(0) {}
+    ~OutStreamBuffer() { flush(); }
+
+    // a short write (disk full, closed pipe) stops the generator, a partial
+    // instance must not look like a complete one
+    void flush() {
+        if (fwrite(buf, 1, pos, out) != static_cast<size_t>(pos))
+            fprintf(stderr, "ERROR! Could not write output: %s\n", strerror(errno)), exit(1);
+        pos = 0; }
+
+    void putStr(const std::string &str) {
+        for (auto c : str) { assureSpace(1); buf[pos++] = c; } }
+
+    void putInt(long long val) {
+        char digits[24];
+        int  size = 0;
+        assureSpace(sizeof(digits));
+        if (val < 0) buf[pos++] = '-', val = -val;
+        do { digits[size++] = '0' + val % 10; val /= 10; } while (val > 0);
+        while (size > 0) buf[pos++] = digits[--size]; }
+
+    void putClause(const std::vector<int> &clause) {
+        for (auto lit : clause) { putInt(lit); assureSpace(1); buf[pos++] = ' '; }
+        putStr("0\n"); }
+};
+
+// splitmix64: same sequence on every platform, unlike std distributions
+class Random {
+    unsigned long long state;
+
+    public:
+    explicit Random(unsigned long long seed) : state(seed) {}
+
+    unsigned long long next() {
+        unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31); }
+
+    int range(int size) { return next() % size; } // [0, size)
+};
+
+struct GenConfig {
+    std::string family;
+    int vars;
+    long long clauses;
+    double ratio;
+    int k;
+    int size;
+    bool sat;
+    unsigned long long seed;
+    std::string output;
+
+    GenConfig() : vars(0), clauses(0), ratio(0), k(3), size(0), sat(false), seed(1) {}
+};
+
+static void random_clause(Random &rng, int vars, int k, std::vector<int> &clause){
+    clause.clear();
+    while (static_cast<int>(clause.size()) < k) {
+        int var = rng.range(vars) + 1;
+        bool duplicated = false;
+        for (auto lit : clause)
+            if (std::abs(lit) == var) duplicated = true;
+        if (!duplicated) clause.push_back(rng.range(2) ? var : -var);
+    }
+}
+
+static void gen_random(const GenConfig &config, OutStreamBuffer &out, bool planted){
+    Random rng(config.seed);
+    std::vector<bool> hidden;
+    if (planted) {
+        hidden.resize(config.vars + 1);
+        for (int var = 1; var <= config.vars; var++) hidden[var] = rng.range(2);
+    }
+
+    out.putStr("p cnf "); out.putInt(config.vars);
+    out.putStr(" "); out.putInt(config.clauses); out.putStr("\n");
+
+    std::vector<int> clause;
+    for (long long i = 0; i < config.clauses; i++) {
+        random_clause(rng, config.vars, config.k, clause);
+        if (planted) {
+            // resample until the hidden assignment satisfies the clause
+            bool is_sat = false;
+            while (!is_sat) {
+                for (auto lit : clause)
+                    if (hidden[std::abs(lit)] == (lit > 0)) is_sat = true;
+                if (!is_sat) random_clause(rng, config.vars, config.k, clause);
+            }
+        }
+        out.putClause(clause);
+    }
+}
+
+static void gen_parity(const GenConfig &config, OutStreamBuffer &out){
+    /*
+     * variables: chain c_0 .. c_{2D-1} = 1 .. 2D, free f_0 .. f_{D-1} = 2D+1 .. 3D
+     * xor j:     c_j ^ c_{(j+1) mod 2D} ^ f_{j mod D} = parity_j
+     * parity_j:  0, except parity_0 = 1 when UNSAT
+     */
+    int d = config.size;
+    Random rng(config.seed);
+
+    // random renaming of variables, so the chain is not in index order
+    std::vector<int> name(3 * d + 1);
+    for (int var = 1; var <= 3 * d; var++) name[var] = var;
+    for (int var = 3 * d; var > 1; var--) std::swap(name[var], name[rng.range(var) + 1]);
+
+    out.putStr("p cnf "); out.putInt(3 * d);
+    out.putStr(" "); out.putInt(8LL * d); out.putStr("\n");
+
+    std::vector<int> clause(3);
+    for (int j = 0; j < 2 * d; j++) {
+        int xor_vars[3] = { name[j + 1], name[(j + 1) % (2 * d) + 1], name[2 * d + j % d + 1] };
+        int parity = (j == 0 && !config.sat) ? 1 : 0;
+
+        // forbid every assignment of the 3 variables whose parity is wrong
+        for (int assignment = 0; assignment < 8; assignment++) {
+            int ones = __builtin_popcount(assignment);
+            if (ones % 2 == parity) continue;
+            for (int i = 0; i < 3; i++)
+                clause[i] = (assignment >> i & 1) ? -xor_vars[i] : xor_vars[i];
+            out.putClause(clause);
+        }
+    }
+}
+
+static void gen_php(const GenConfig &config, OutStreamBuffer &out){
+    /* pigeon i in hole j: variable i * N + j + 1 */
+    long long n = config.size;
+
+    out.putStr("p cnf "); out.putInt((n + 1) * n);
+    out.putStr(" "); out.putInt((n + 1) + n * (n + 1) * n / 2); out.putStr("\n");
+
+    std::vector<int> clause;
+    for (long long i = 0; i <= n; i++) {
+        clause.clear();
+        for (long long j = 0; j < n; j++) clause.push_back(i * n + j + 1);
+        out.putClause(clause);
+    }
+
+    clause.resize(2);
+    for (long long j = 0; j < n; j++)
+        for (long long i = 0; i <= n; i++)
+            for (long long k = i + 1; k <= n; k++) {
+                clause[0] = -(i * n + j + 1);
+                clause[1] = -(k * n + j + 1);
+                out.putClause(clause);
+            }
+}
+
+static void print_usage(){
+    std::cerr << "./yasat_gen random  --vars N (--ratio R | --clauses M) [--k K]" << std::endl;
+    std::cerr << "./yasat_gen planted --vars N (--ratio R | --clauses M) [--k K]" << std::endl;
+    std::cerr << "./yasat_gen parity  --size D [--sat]" << std::endl;
+    std::cerr << "./yasat_gen php     --holes N" << std::endl;
+    std::cerr << "    common options: --seed S, -o output.cnf" << std::endl;
+}
+
+int main(int argc, char *argv[]){
+    if (argc < 2) { print_usage(); return 1; }
+
+    GenConfig config;
+    config.family = argv[1];
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--sat") { config.sat = true; continue; }
+        if (i + 1 >= argc) { print_usage(); return 1; }
+
+        if      (arg == "--vars")    config.vars = std::atoi(argv[++i]);
+        else if (arg == "--clauses") config.clauses = std::atoll(argv[++i]);
+        else if (arg == "--ratio")   config.ratio = std::atof(argv[++i]);
+        else if (arg == "--k")       config.k = std::atoi(argv[++i]);
+        else if (arg == "--size" || arg == "--holes") config.size = std::atoi(argv[++i]);
+        else if (arg == "--seed")    config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "-o")        config.output = argv[++i];
+        else { print_usage(); return 1; }
+    }
+
+    bool is_random = config.family == "random" || config.family == "planted";
+    bool is_family = is_random || config.family == "parity" || config.family == "php";
+    if (is_random && config.clauses == 0)
+        config.clauses = static_cast<long long>(config.vars * config.ratio + 0.5);
+
+    if (!is_family ||
+        (is_random && (config.vars < config.k || config.k < 1 || config.clauses < 1)) ||
+        (!is_random && config.size < 1)) {
+        print_usage();
+        return 1;
+    }
+
+    FILE *out_file = stdout;
+    if (!config.output.empty()) {
+        out_file = fopen(config.output.c_str(), "w");
+        if (out_file == NULL) {
+            fprintf(stderr, "ERROR! Could not open file: %s\n", config.output.c_str());
+            return 1;
+        }
+    }
+
+    {
+        OutStreamBuffer out(out_file);
+        out.putStr("c yasat_gen " + config.family + " seed " + std::to_string(config.seed) + "\n");
+
+        if      (config.family == "random")  gen_random(config, out, false);
+        else if (config.family == "planted") gen_random(config, out, true);
+        else if (config.family == "parity")  gen_parity(config, out);
+        else if (config.family == "php")     gen_php(config, out);
+    }
+
+    // stdout too, its buffered data is written here
+    if (fclose(out_file) != 0) {
+        fprintf(stderr, "ERROR! Could not write output: %s\n", strerror(errno));
+        return 1;
+    }
+    return 0;
+}
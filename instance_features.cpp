@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+#include "instance_features.h"
+
+void InstanceFeatures::clause(const std::vector<int>& lits){
+    int size = lits.size();
+    clause_count++;
+    literal_count += size;
+    size_histogram[std::min(std::max(size, 1), 5) - 1]++;
+    if( size == 2 && lits[0] < 0 && lits[1] < 0 ) negative_binary_count++;
+
+    for( auto lit : lits ){
+        int var = std::abs(lit);
+        if( var >= static_cast<int>(var_degree.size()) ) var_degree.resize(2 * var + 1, 0);
+        var_degree[var]++;
+    }
+
+    if( size < 3 || size > 4 ) return;
+
+    // sign pattern of the clause over its sorted variables, insertion sort of at most 4
+    std::array<int, 4> sorted_lits;
+    for( int i = 0; i < size; i++ ){
+        int j = i;
+        for( ; j > 0 && std::abs(sorted_lits[j - 1]) > std::abs(lits[i]); j-- ){
+            sorted_lits[j] = sorted_lits[j - 1];
+        }
+        sorted_lits[j] = lits[i];
+    }
+
+    unsigned int pattern = 0;
+    int negative_count = 0;
+    for( int i = 0; i < size; i++ ){
+        if( sorted_lits[i] < 0 ){
+            pattern |= 1u << i;
+            negative_count++;
+        }
+    }
+
+    XorCandidate& candidate = xor_candidates[xor_key(sorted_lits.data(), size)];
+    if( negative_count % 2 == 0 ) candidate.even_patterns |= 1u << pattern;
+    else candidate.odd_patterns |= 1u << pattern;
+    candidate.clause_count++;
+    candidate.size = size;
+}
+
+uint64_t InstanceFeatures::xor_key(const int* sorted_lits, int size){
+    /*
+     * variables below 2^16 are packed exactly, 16 bits each (a 3 variable key has 0 on top),
+     * larger ones are hashed with the top bit set, a collision only blurs the xor score.
+     */
+    uint64_t key = 0;
+    bool is_packed = true;
+    for( int i = 0; i < size; i++ ){
+        uint64_t var = std::abs(sorted_lits[i]);
+        if( var >= (1u << 16) ) is_packed = false;
+        key |= (var & 0xffff) << (16 * i);
+    }
+    if( is_packed ) return key;
+
+    uint64_t hash = size;
+    for( int i = 0; i < size; i++ ){
+        hash = (hash ^ static_cast<uint64_t>(std::abs(sorted_lits[i]))) * 0x9e3779b97f4a7c15ull;
+        hash ^= hash >> 29;
+    }
+    return hash | (1ull << 63);
+}
+
+void InstanceFeatures::cardinality(const std::vector<int>& lits, int){
+    cardinality_count++;
+    for( auto lit : lits ){
+        int var = std::abs(lit);
+        if( var >= static_cast<int>(var_degree.size()) ) var_degree.resize(2 * var + 1, 0);
+        var_degree[var]++;
+    }
+}
+
+std::vector<std::string> InstanceFeatures::names(){
+    return { "size1_ratio", "size2_ratio", "size3_ratio", "size4_ratio", "size5_ratio",
+             "mean_clause_size", "clause_var_ratio",
+             "degree_mean", "degree_max_ratio", "degree_cv",
+             "xor_score", "amo_score", "cardinality_ratio" };
+}
+
+std::vector<double> InstanceFeatures::values() const {
+    double clauses = std::max(clause_count, 1LL);
+
+    // variable degree statistics over variables which appear
+    double degree_sum = 0, degree_square_sum = 0, degree_max = 0, var_count = 0;
+    for( auto degree : var_degree ){
+        if( degree == 0 ) continue;
+        var_count++;
+        degree_sum += degree;
+        degree_square_sum += static_cast<double>(degree) * degree;
+        degree_max = std::max(degree_max, static_cast<double>(degree));
+    }
+    var_count = std::max(var_count, 1.0);
+    double degree_mean = degree_sum / var_count;
+    double degree_variance = std::max(degree_square_sum / var_count - degree_mean * degree_mean, 0.0);
+
+    // complete xor of k variables has 2^(k-1) clauses of one parity
+    long long xor_clauses = 0;
+    for( const auto& item : xor_candidates ){
+        const XorCandidate& candidate = item.second;
+        int full = 1 << (candidate.size - 1);
+        if( __builtin_popcount(candidate.even_patterns) == full ||
+            __builtin_popcount(candidate.odd_patterns) == full ){
+            xor_clauses += candidate.clause_count;
+        }
+    }
+
+    std::vector<double> ret;
+    for( auto count : size_histogram ) ret.push_back(count / clauses);
+    ret.push_back(literal_count / clauses);
+    ret.push_back(clause_count / var_count);
+    ret.push_back(degree_mean);
+    ret.push_back(degree_mean > 0 ? degree_max / degree_mean : 0);
+    ret.push_back(degree_mean > 0 ? std::sqrt(degree_variance) / degree_mean : 0);
+    ret.push_back(xor_clauses / clauses);
+    ret.push_back(negative_binary_count / clauses);
+    ret.push_back(cardinality_count / clauses);
+    return ret;
+}
+
+void InstanceFeatures::print(std::ostream& os) const {
+    std::vector<std::string> feature_names = names();
+    std::vector<double> feature_values = values();
+    for( std::size_t i = 0; i < feature_names.size(); i++ ){
+        os << "c feature_" << feature_names[i] << " = " << feature_values[i] << std::endl;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef __INSTANCE_FEATURES_H__
+#define __INSTANCE_FEATURES_H__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "parser.h"
+
+// InstanceFeatures
+//
+// cheap features of a CNF, computed while parsing as a DIMACSSink:
+//
+//   clause size histogram (1, 2, 3, 4, 5+), mean clause size, binary clause ratio,
+//   variable degree mean, max and coefficient of variation,
+//   xor score: ratio of clauses which are part of a complete xor encoding
+//              (all 2^(k-1) sign patterns of one parity over the same k <= 4 variables),
+//   amo score: ratio of binary clauses with 2 negative literals (pairwise at-most-one).
+//
+// values() / names() give a fixed order feature vector for ConfigSelector.
+class InstanceFeatures : public DIMACSSink {
+public:
+    InstanceFeatures() : clause_count(0), literal_count(0), negative_binary_count(0),
+                         cardinality_count(0), size_histogram(5, 0) {}
+
+    void clause(const std::vector<int>& lits);
+    void cardinality(const std::vector<int>& lits, int bound);
+
+    std::vector<double> values() const;
+    static std::vector<std::string> names();
+    void print(std::ostream& os) const; // `c feature_<name> = value' lines
+
+private:
+    long long clause_count;
+    long long literal_count;
+    long long negative_binary_count;
+    long long cardinality_count;
+    std::vector<long long> size_histogram;
+    std::vector<int> var_degree; // 1-based
+
+    // sorted variables of short clause (xor_key()) => seen sign patterns, and clause count
+    struct XorCandidate {
+        unsigned int even_patterns;
+        unsigned int odd_patterns;
+        int clause_count;
+        int size;
+        XorCandidate() : even_patterns(0), odd_patterns(0), clause_count(0), size(0) {}
+    };
+    static uint64_t xor_key(const int* sorted_lits, int size);
+    std::unordered_map<uint64_t, XorCandidate> xor_candidates;
+};
+
+#endif /* end of include guard: __INSTANCE_FEATURES_H__ */
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+
+#include "lookahead.h"
+#include "trace.h"
+
+constexpr double LookaheadEngine::dl_decay;
+
+BoolVal SatSolver::lookahead_search(){
+    BoolVal result = LookaheadEngine(*this).search();
+    engine_bytes = 0;
+    return result;
+}
+
+LookaheadEngine::LookaheadEngine(SatSolver& solver) :
+    solver(solver), stamp(0), node(0), dl_trigger(0)
+{
+    int lit_size = 2 * (solver.max_var_index + 1);
+    occurs.resize(lit_size);
+    occurrence_score.assign(solver.max_var_index + 1, 0);
+
+    int clause_size = solver.all_clauses.size();
+    for( int clause_index = 0; clause_index < clause_size; clause_index++ ){
+        const Clause& clause = solver.all_clauses[clause_index];
+        double weight = std::pow(5.0, 2.0 - clause.size());
+        for( auto lit : clause ){
+            occurs[SatSolver::lit_code(lit)].push_back(clause_index);
+            occurrence_score[std::abs(lit)] += weight;
+        }
+    }
+    clause_stamp.assign(clause_size, 0);
+    dl_node.assign(lit_size, 0);
+    learned.resize(lit_size);
+    learned_node.assign(lit_size, 0);
+
+    std::size_t bytes = 0;
+    for( const auto& lits : occurs ) bytes += lits.capacity() * sizeof(int);
+    bytes += occurs.capacity() * sizeof(std::vector<int>) * 2; // occurs and learned
+    bytes += (clause_size + 2 * lit_size) * sizeof(long long);
+    solver.engine_bytes = bytes;
+}
+
+BoolVal LookaheadEngine::search(){
+    TRACE_SCOPE("lookahead_search");
+
+    // occurrence lists of the engine count against the memory limit too
+    if( solver.check_memory() ){
+        return BoolVal::NOT_ASSIGNED;
+    }
+
+    // assumptions first, they are never inverted
+    for( auto lit : solver.assumptions ){
+        BoolVal value = solver.literals[std::abs(lit)].value;
+        if( value == to_bool_val(lit > 0) ) continue;
+        if( value != BoolVal::NOT_ASSIGNED || !push_implied(lit) ){
+            return BoolVal::FALSE;
+        }
+    }
+
+    while( 1 ){
+        if( stopped() ){
+            return BoolVal::NOT_ASSIGNED;
+        }
+
+        int branch = 0;
+        bool is_conflict = !node_lookahead(branch);
+        if( !is_conflict ){
+            if( branch == 0 ){
+                return BoolVal::TRUE;
+            }
+            solver.decisions += 1;
+            solver.backtrack_level += 1;
+            solver.backtrack_data.push_back(SatSolver::BT());
+            solver.decision_literals.emplace_back(std::abs(branch), branch > 0, 0);
+            is_conflict = solver.imply_by(std::abs(branch), branch > 0).type == SatRetValue::CONFLICT;
+        }
+
+        // chronological backtracking, the inverted decision is implied on its level
+        while( is_conflict ){
+            solver.conflicts += 1;
+            if( solver.conflict_budget >= 0 && solver.conflicts > solver.conflict_budget ){
+                return BoolVal::NOT_ASSIGNED;
+            }
+            if( !solver.backtrack_next() ){
+                return BoolVal::FALSE;
+            }
+            const LiteralDecideNode& inverted = solver.decision_literals.back();
+            is_conflict = solver.imply_by(inverted.lit_number, inverted.value).type == SatRetValue::CONFLICT;
+        }
+    }
+}
+
+bool LookaheadEngine::node_lookahead(int& branch){
+    node += 1;
+    dl_trigger *= dl_decay;
+
+    // look again after forced literals, they change the reductions of the others
+    while( 1 ){
+        preselect();
+        branch = 0;
+        long long best_score = -1;
+        bool is_forced = false;
+
+        for( auto var : candidates ){
+            if( solver.literals[var].value != BoolVal::NOT_ASSIGNED ) continue; // forced in this round
+
+            long long pos_diff = 0, neg_diff = 0;
+            bool pos_ok = look(var, pos_diff);
+            bool neg_ok = look(-var, neg_diff);
+            if( !pos_ok && !neg_ok ){
+                return false;
+            }
+            if( !pos_ok || !neg_ok ){
+                solver.lookahead_stats.failed_literals += 1;
+                if( !push_implied(pos_ok ? var : -var) ) return false;
+                is_forced = true;
+                continue;
+            }
+
+            long long score = 1024 * pos_diff * neg_diff + pos_diff + neg_diff;
+            if( score > best_score ){
+                best_score = score;
+                branch = pos_diff <= neg_diff ? var : -var;
+            }
+        }
+        if( !is_forced ) return true;
+    }
+}
+
+bool LookaheadEngine::look(int lit, long long& diff){
+    solver.lookahead_stats.lookaheads += 1;
+    int level = solver.backtrack_level;
+    int code = SatSolver::lit_code(lit);
+    bool is_ok = push_implied(lit);
+
+    // local learning: implications of lit found by double lookahead at this node
+    if( is_ok && learned_node[code] == node ){
+        for( auto implied : learned[code] ){
+            BoolVal value = solver.literals[std::abs(implied)].value;
+            if( value == to_bool_val(implied > 0) ) continue;
+            if( value != BoolVal::NOT_ASSIGNED || !push_implied(implied) ){
+                is_ok = false;
+                break;
+            }
+        }
+    }
+
+    if( is_ok ){
+        diff = new_binaries(level);
+        if( diff > dl_trigger && dl_node[code] != node ){
+            is_ok = double_look(lit, diff);
+        }
+    }
+    pop_to(level);
+    return is_ok;
+}
+
+bool LookaheadEngine::double_look(int lit, long long diff){
+    /*
+     * below lit, look ahead on the candidates once more: a failed m gives lit => -m,
+     * -m is implied below lit at once, m and -m both failed: lit is failed too.
+     */
+    solver.lookahead_stats.double_lookaheads += 1;
+    dl_node[SatSolver::lit_code(lit)] = node;
+
+    bool is_learned = false;
+    for( auto var : candidates ){
+        for( int m : { var, -var } ){
+            if( solver.literals[var].value != BoolVal::NOT_ASSIGNED ) break;
+
+            int level = solver.backtrack_level;
+            bool is_ok = push_implied(m);
+            pop_to(level);
+            if( is_ok ) continue;
+
+            add_learned(lit, -m);
+            add_learned(m, -lit);
+            is_learned = true;
+            if( !push_implied(-m) ) return false;
+        }
+    }
+
+    // nothing learned: look twice only for larger reductions
+    if( !is_learned ){
+        dl_trigger = diff;
+    }
+    return true;
+}
+
+bool LookaheadEngine::push_implied(int lit){
+    solver.backtrack_level += 1;
+    solver.backtrack_data.push_back(SatSolver::BT());
+    solver.decision_literals.emplace_back(std::abs(lit), lit > 0, 1);
+    return solver.imply_by(std::abs(lit), lit > 0).type != SatRetValue::CONFLICT;
+}
+
+void LookaheadEngine::pop_to(int level){
+    while( solver.backtrack_level > level ){
+        solver.backtrack_pop();
+    }
+}
+
+void LookaheadEngine::add_learned(int lit, int implied){
+    int code = SatSolver::lit_code(lit);
+    if( learned_node[code] != node ){
+        learned[code].clear();
+        learned_node[code] = node;
+    }
+    learned[code].push_back(implied);
+    solver.lookahead_stats.learned_implications += 1;
+}
+
+void LookaheadEngine::preselect(){
+    candidates.clear();
+    for( int var = 1; var <= solver.max_var_index; var++ ){
+        if( solver.literals[var].value == BoolVal::NOT_ASSIGNED ){
+            candidates.push_back(var);
+        }
+    }
+
+    std::size_t limit = std::max<std::size_t>(candidate_min, candidates.size() * candidate_percent / 100);
+    if( candidates.size() > limit ){
+        std::partial_sort(candidates.begin(), candidates.begin() + limit, candidates.end(),
+                          [this](int a, int b){ return occurrence_score[a] > occurrence_score[b]; });
+        candidates.resize(limit);
+    }
+}
+
+long long LookaheadEngine::new_binaries(int level){
+    /*
+     * clauses which lost a literal on the levels above `level' and have 2 free literals
+     * and no true one left, each counted once.
+     */
+    stamp += 1;
+    long long count = 0;
+    for( int i = level; i < solver.backtrack_level; i++ ){
+        for( auto var : solver.backtrack_data[i].updated_literals ){
+            int false_lit = solver.literals[var].value == BoolVal::TRUE ? -var : var;
+
+            for( auto clause_index : occurs[SatSolver::lit_code(false_lit)] ){
+                if( clause_stamp[clause_index] == stamp || solver.sat_clauses[clause_index] ) continue;
+                clause_stamp[clause_index] = stamp;
+
+                int free_lits = 0;
+                for( auto lit : solver.all_clauses[clause_index] ){
+                    BoolVal value = solver.literals[std::abs(lit)].value;
+                    if( value == to_bool_val(lit > 0) ){
+                        free_lits = -1;
+                        break;
+                    }
+                    if( value == BoolVal::NOT_ASSIGNED ) free_lits += 1;
+                }
+                if( free_lits == 2 ) count += 1;
+            }
+        }
+    }
+    return count;
+}
+
+bool LookaheadEngine::stopped(){
+    if( solver.terminate_flag && solver.terminate_flag->load(std::memory_order_relaxed) ){
+        return true;
+    }
+    return solver.memory_over_limit();
+}
@@ -0,0 +1,60 @@
+#ifndef __LOOKAHEAD_H__
+#define __LOOKAHEAD_H__
+
+#include <vector>
+
+#include "sat_solver.h"
+#include "utils.h"
+
+// LookaheadEngine: march style lookahead search, SatSolver::set_engine(SearchEngine::LOOKAHEAD)
+//
+// the search is chronological as DPLL_backtrack(), but each node looks ahead before branching,
+// with imply_by() on temporary levels which are popped again:
+//
+//   1. preselection: free variables with the highest occurrence score (short clauses weigh more)
+//   2. lookahead:    each candidate literal is implied. a conflict makes it a failed literal and its
+//                    negation is forced, both sides failed: the node conflicts.
+//                    otherwise diff = number of clauses which became binary (difference heuristic)
+//   3. double lookahead: when diff is above a self adjusting trigger, candidates are looked ahead
+//                    again below the literal l. a failed m gives l => -m and m => -l, kept in a
+//                    local learning cache of the node, which later lookaheads of l and m apply
+//   4. branch:       candidate with the highest 1024 * diff(x) * diff(-x) + diff(x) + diff(-x),
+//                    the side with fewer new binary clauses first
+//
+// forced literals are pushed as decisions with bt_state 1 like assumptions, so backtrack_next()
+// undoes them together with the decision they depend on.
+class LookaheadEngine {
+public:
+    explicit LookaheadEngine(SatSolver& solver);
+    BoolVal search(); // TRUE: SAT, FALSE: UNSAT, NOT_ASSIGNED: stopped by a limit
+
+private:
+    bool node_lookahead(int& branch); // false: conflict at the node, branch 0: all variables assigned
+    bool look(int lit, long long& diff);  // false: lit is a failed literal
+    bool double_look(int lit, long long diff);
+    bool push_implied(int lit);       // on a new level with bt_state 1, false: conflict
+    void pop_to(int level);
+    void add_learned(int lit, int implied);
+    void preselect();
+    long long new_binaries(int level);
+    bool stopped();
+
+    static const int candidate_min = 20;     // preselect at least this many variables,
+    static const int candidate_percent = 10; // or this percentage of free variables
+    static constexpr double dl_decay = 0.95; // double lookahead trigger decays every node
+
+    SatSolver& solver;
+    vector_2d<int> occurs;                  // lit_code(lit) => clauses which contain lit
+    std::vector<double> occurrence_score;   // variable => preselection score
+    std::vector<int> candidates;
+
+    std::vector<long long> clause_stamp;    // clause counted by new_binaries() call `stamp'
+    long long stamp;
+    long long node;                         // lookahead node, stamps of the caches below
+    double dl_trigger;
+    std::vector<long long> dl_node;         // lit_code(lit) => node of its last double lookahead
+    vector_2d<int> learned;                 // lit_code(lit) => literals implied by lit at learned_node
+    std::vector<long long> learned_node;
+};
+
+#endif /* end of include guard: __LOOKAHEAD_H__ */
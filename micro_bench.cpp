@@ -0,0 +1,252 @@
+/*
+ * micro benchmark of solver kernels
+ *
+ *   ./yasat_bench [--vars N] [--clauses M] [--reps R] [--seed S]
+ *
+ * inputs are synthetic random 3-SAT instances generated from the seed,
+ * each kernel runs R times and one JSON line of summary is printed per kernel:
+ *
+ *   {"kernel": "parse_DIMACS", "unit": "MB/s", "reps": 10, "min": ..., "median": ..., ...}
+ *
+ * output of two commits can be compared by tools/bench_compare.py.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "parser.h"
+#include "sat_solver.h"
+#include "search_policy.h"
+
+struct BenchConfig {
+    int vars;
+    int clauses;
+    int reps;
+    unsigned int seed;
+
+    BenchConfig() : vars(20000), clauses(60000), reps(10), seed(1) {}
+};
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_seconds(Clock::time_point start){
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void print_summary(const std::string& kernel, const std::string& unit, std::vector<double> samples){
+    /* samples are rates, print min, median, mean, max and standard deviation */
+    std::sort(samples.begin(), samples.end());
+
+    int size = samples.size();
+    double mean = 0;
+    for( auto sample : samples ) mean += sample;
+    mean /= size;
+
+    double variance = 0;
+    for( auto sample : samples ) variance += (sample - mean) * (sample - mean);
+    double stddev = size > 1 ? std::sqrt(variance / (size - 1)) : 0;
+
+    double median = size % 2 ? samples[size / 2] : (samples[size / 2 - 1] + samples[size / 2]) / 2;
+
+    std::printf("{\"kernel\": \"%s\", \"unit\": \"%s\", \"reps\": %d, "
+                "\"min\": %.6g, \"median\": %.6g, \"mean\": %.6g, \"max\": %.6g, \"stddev\": %.6g}\n",
+                kernel.c_str(), unit.c_str(), size,
+                samples.front(), median, mean, samples.back(), stddev);
+    std::fflush(stdout);
+}
+
+static std::vector<Clause> random_3sat(const BenchConfig& config){
+    std::mt19937 rng(config.seed);
+    std::uniform_int_distribution<int> var_dist(1, config.vars);
+    std::uniform_int_distribution<int> sign_dist(0, 1);
+
+    std::vector<Clause> clauses(config.clauses);
+    for( auto& clause : clauses ){
+        while( clause.size() < 3 ){
+            int var = var_dist(rng);
+            bool duplicated = false;
+            for( auto lit : clause ){
+                if( std::abs(lit) == var ) duplicated = true;
+            }
+            if( !duplicated ) clause.push_back(sign_dist(rng) ? var : -var);
+        }
+    }
+    return clauses;
+}
+
+static std::string to_DIMACS(const std::vector<Clause>& clauses, int vars){
+    std::string text = "c synthetic random 3-SAT\n";
+    text += "p cnf " + std::to_string(vars) + " " + std::to_string(clauses.size()) + "\n";
+    for( const auto& clause : clauses ){
+        for( auto lit : clause ){
+            text += std::to_string(lit);
+            text += ' ';
+        }
+        text += "0\n";
+    }
+    return text;
+}
+
+static std::vector<std::pair<int, bool>> assignment_sequence(const BenchConfig& config){
+    /* fixed order of decisions: every variable once, random value */
+    std::mt19937 rng(config.seed + 1);
+    std::vector<std::pair<int, bool>> sequence;
+    for( int var = 1; var <= config.vars; var++ ){
+        sequence.emplace_back(var, rng() % 2 == 0);
+    }
+    std::shuffle(sequence.begin(), sequence.end(), rng);
+    return sequence;
+}
+
+static void prepare_solver(SatSolver& solver, const std::vector<Clause>& clauses, int vars){
+    solver.set_clauses(clauses, vars);
+    solver.add_2_lit_watch_each_clause();
+}
+
+static void bench_parser(const std::string& text, int reps){
+    std::vector<double> rates;
+    for( int rep = 0; rep < reps; rep++ ){
+        std::vector<Clause> clauses;
+        FILE *in = fmemopen(const_cast<char*>(text.data()), text.size(), "r");
+
+        Clock::time_point start = Clock::now();
+        parse_DIMACS(in, clauses);
+        double seconds = elapsed_seconds(start);
+
+        std::fclose(in);
+        rates.push_back(text.size() / seconds / 1e6);
+    }
+    print_summary("parse_DIMACS", "MB/s", rates);
+}
+
+static void bench_watch_setup(const std::vector<Clause>& clauses, int vars, int reps){
+    std::vector<double> rates;
+    for( int rep = 0; rep < reps; rep++ ){
+        SatSolver solver;
+        solver.set_clauses(clauses, vars);
+
+        Clock::time_point start = Clock::now();
+        solver.add_2_lit_watch_each_clause();
+        double seconds = elapsed_seconds(start);
+
+        rates.push_back(clauses.size() / seconds);
+    }
+    print_summary("add_2_lit_watch_each_clause", "clauses/s", rates);
+}
+
+static void bench_propagation(const std::vector<Clause>& clauses, int vars, int reps,
+                              const std::vector<std::pair<int, bool>>& sequence){
+    /*
+     * decide literals of `sequence' one by one and propagate by imply_by<FastPolicy>(),
+     * the propagation of the search without limits, statistics and cardinality constraints.
+     * a decision level which conflicts is undone, then all levels are undone at the end.
+     */
+    std::vector<double> imply_rates, undo_rates;
+    for( int rep = 0; rep < reps; rep++ ){
+        SatSolver solver;
+        prepare_solver(solver, clauses, vars);
+
+        long long assigned = 0;
+        Clock::time_point start = Clock::now();
+        for( const auto& decision : sequence ){
+            if( solver.literals[decision.first].value != BoolVal::NOT_ASSIGNED ) continue;
+
+            solver.backtrack_level += 1;
+            solver.backtrack_data.push_back(SatSolver::BT());
+            solver.decision_literals.emplace_back(decision.first, decision.second, 0);
+
+            SatRetValue ret = solver.imply_by<FastPolicy>(decision.first, decision.second);
+            assigned += solver.backtrack_data.back().updated_literals.size();
+            if( ret.type == SatRetValue::CONFLICT ){
+                solver.backtrack_pop();
+            }
+        }
+        imply_rates.push_back(assigned / elapsed_seconds(start));
+
+        long long undone = 0;
+        for( const auto& layer : solver.backtrack_data ){
+            undone += layer.updated_literals.size() + layer.updated_sat_clauses.size();
+        }
+        start = Clock::now();
+        while( solver.backtrack_level > 0 ){
+            solver.backtrack_pop();
+        }
+        undo_rates.push_back(undone / elapsed_seconds(start));
+    }
+    print_summary("imply_by", "assignments/s", imply_rates);
+    print_summary("remove_last_backtrack_data", "entries/s", undo_rates);
+}
+
+static void bench_update_literal(const std::vector<Clause>& clauses, int vars, int reps,
+                                 const std::vector<std::pair<int, bool>>& sequence){
+    /*
+     * assign the first half of `sequence' without propagation,
+     * then visit both watched literals of every clause by update_literal().
+     */
+    std::vector<double> rates;
+    for( int rep = 0; rep < reps; rep++ ){
+        SatSolver solver;
+        prepare_solver(solver, clauses, vars);
+
+        solver.backtrack_level = 1;
+        solver.backtrack_data.push_back(SatSolver::BT());
+        for( int i = 0; i < static_cast<int>(sequence.size()) / 2; i++ ){
+            solver.bt_assign_literal(sequence[i].first, sequence[i].second);
+        }
+
+        long long visits = 0;
+        int clause_size = clauses.size();
+        Clock::time_point start = Clock::now();
+        for( int clause_index = 0; clause_index < clause_size; clause_index++ ){
+            solver.update_literal(clause_index, 0);
+            solver.update_literal(clause_index, 1);
+            visits += 2;
+        }
+        rates.push_back(visits / elapsed_seconds(start));
+    }
+    print_summary("update_literal", "visits/s", rates);
+}
+
+int main(int argc, char *argv[]){
+    BenchConfig config;
+
+    for( int i = 1; i < argc; i++ ){
+        std::string arg = argv[i];
+        if( i + 1 >= argc ){
+            std::cerr << "missing value of " << arg << std::endl;
+            return 1;
+        }
+
+        if( arg == "--vars" )         config.vars = std::atoi(argv[++i]);
+        else if( arg == "--clauses" ) config.clauses = std::atoi(argv[++i]);
+        else if( arg == "--reps" )    config.reps = std::atoi(argv[++i]);
+        else if( arg == "--seed" )    config.seed = std::strtoul(argv[++i], nullptr, 10);
+        else{
+            std::cerr << "./yasat_bench [--vars N] [--clauses M] [--reps R] [--seed S]" << std::endl;
+            return 1;
+        }
+    }
+
+    if( config.vars < 3 || config.clauses < 1 || config.reps < 1 ){
+        std::cerr << "invalid benchmark size" << std::endl;
+        return 1;
+    }
+
+    std::vector<Clause> clauses = random_3sat(config);
+    std::vector<std::pair<int, bool>> sequence = assignment_sequence(config);
+
+    bench_parser(to_DIMACS(clauses, config.vars), config.reps);
+    bench_watch_setup(clauses, config.vars, config.reps);
+    bench_propagation(clauses, config.vars, config.reps, sequence);
+    bench_update_literal(clauses, config.vars, config.reps, sequence);
+
+    return 0;
+}
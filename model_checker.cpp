@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "model_checker.h"
+
+BoolVal ModelChecker::read_model(std::istream& answer_stream){
+    BoolVal status = BoolVal::NOT_ASSIGNED;
+    true_lits.clear();
+    model_max_var = 0;
+    conflicting_var = 0;
+
+    std::string line;
+    while( std::getline(answer_stream, line) ){
+        std::istringstream tokens(line);
+        std::string type;
+        if( !(tokens >> type) ) continue;
+
+        if( type == "s" ){
+            std::string result;
+            tokens >> result;
+            if( result == "SATISFIABLE" ) status = BoolVal::TRUE;
+            if( result == "UNSATISFIABLE" ) status = BoolVal::FALSE;
+        }
+        else if( type == "v" ){
+            std::string token;
+            while( tokens >> token ){
+                // not assigned literal is `@x' in DEBUG build
+                int lit = std::atoi(token.c_str());
+                if( lit != 0 ) set_true(lit);
+            }
+        }
+    }
+    return status;
+}
+
+void ModelChecker::set_model(const std::vector<BoolVal>& answer){
+    true_lits.assign(2 * (answer.size() + 1), false);
+    model_max_var = 0;
+    conflicting_var = 0;
+    int size = answer.size();
+    for( int i = 0; i < size; i++ ){
+        if( answer[i] == BoolVal::TRUE ) set_true(i + 1);
+        if( answer[i] == BoolVal::FALSE ) set_true(-(i + 1));
+    }
+}
+
+bool ModelChecker::is_true(int lit) const {
+    std::size_t code = SatSolver::lit_code(lit);
+    return code < true_lits.size() && true_lits[code];
+}
+
+void ModelChecker::set_true(int lit){
+    std::size_t code = SatSolver::lit_code(lit);
+    if( code >= true_lits.size() ){
+        true_lits.resize(2 * code + 2, false);
+    }
+    // x and -x together would satisfy every clause
+    if( true_lits[code ^ 1] && conflicting_var == 0 ){
+        conflicting_var = std::abs(lit);
+    }
+    true_lits[code] = true;
+    model_max_var = std::max(model_max_var, std::abs(lit));
+}
+
+void ModelChecker::set_var_range(int max_var){
+    var_range = std::max(var_range, max_var);
+}
+
+void ModelChecker::header(int vars, int clauses){
+    set_var_range(vars);
+}
+
+void ModelChecker::add_range(const std::vector<int>& lits){
+    for( auto lit : lits ){
+        var_range = std::max(var_range, std::abs(lit));
+    }
+}
+
+void ModelChecker::clause(const std::vector<int>& lits){
+    bool is_sat = false;
+    for( auto lit : lits ){
+        if( is_true(lit) ){
+            is_sat = true;
+            break;
+        }
+    }
+    add_range(lits);
+    record(is_sat, lits);
+}
+
+void ModelChecker::cardinality(const std::vector<int>& lits, int bound){
+    int true_count = 0;
+    for( auto lit : lits ){
+        if( is_true(lit) ) true_count++;
+    }
+    add_range(lits);
+    record(true_count <= bound, lits);
+}
+
+void ModelChecker::record(bool is_sat, const std::vector<int>& lits){
+    if( !is_sat ){
+        if( failed_count == 0 ){
+            first_failed_index = checked_count;
+            first_failed_lits = lits;
+        }
+        failed_count++;
+    }
+    checked_count++;
+}
+
+void ModelChecker::print_report(std::ostream& os) const {
+    os << "c verify_checked = " << checked_count << std::endl;
+    os << "c verify_failed = " << failed_count << std::endl;
+    if( failed_count > 0 ){
+        os << "c verify_first_failed = " << first_failed_index << ":";
+        for( auto lit : first_failed_lits ){
+            os << " " << lit;
+        }
+        os << std::endl;
+    }
+    if( conflicting_var != 0 ){
+        os << "c verify_model_error = variable " << conflicting_var << " is both true and false" << std::endl;
+    }
+    if( model_max_var > var_range ){
+        os << "c verify_model_error = variable " << model_max_var << " is not in the formula (" << var_range << " variables)" << std::endl;
+    }
+    os << "c verify = " << (is_ok() ? "OK" : "FAILED") << std::endl;
+}
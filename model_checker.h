@@ -0,0 +1,60 @@
+#ifndef __MODEL_CHECKER_H__
+#define __MODEL_CHECKER_H__
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "parser.h"
+#include "sat_solver.h"
+
+// ModelChecker
+//
+// checks clauses against a model one by one. It is a DIMACSSink, so
+//
+//   ModelChecker checker;
+//   checker.read_model(answer_stream);
+//   parse_DIMACS_stream(checker, "problem.cnf");
+//
+// verifies an answer file with the memory of the model only.
+// The model is a bit vector over literals, true_lits[lit_code(lit)].
+// A model which sets both x and -x, or a variable beyond the formula
+// (`p cnf' header or largest literal), fails the check.
+class ModelChecker : public DIMACSSink {
+public:
+    ModelChecker() : checked_count(0), failed_count(0), first_failed_index(-1),
+                     model_max_var(0), var_range(0), conflicting_var(0) {}
+
+    // TRUE: `s SATISFIABLE', FALSE: `s UNSATISFIABLE', NOT_ASSIGNED: other
+    // `v' lines may span many lines, blank lines are skipped.
+    BoolVal read_model(std::istream& answer_stream);
+    void set_model(const std::vector<BoolVal>& answer); // answer[i] is x(i+1)
+    void set_var_range(int max_var);                    // without a streamed header
+
+    void header(int vars, int clauses);
+    void clause(const std::vector<int>& lits);
+    void cardinality(const std::vector<int>& lits, int bound);
+
+    bool is_ok() const { return failed_count == 0 && model_ok(); }
+    bool model_ok() const { return conflicting_var == 0 && model_max_var <= var_range; }
+    void print_report(std::ostream& os) const; // `c key = value' lines
+
+private:
+    bool is_true(int lit) const;
+    void set_true(int lit);
+    void record(bool is_sat, const std::vector<int>& lits);
+    void add_range(const std::vector<int>& lits);
+
+    std::vector<bool> true_lits;
+
+    long long checked_count;
+    long long failed_count;
+    long long first_failed_index;
+    std::vector<int> first_failed_lits;
+
+    int model_max_var;   // largest variable of the model
+    int var_range;       // variables of the formula
+    int conflicting_var; // first variable set to both values, 0: none
+};
+
+#endif /* end of include guard: __MODEL_CHECKER_H__ */
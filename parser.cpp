@@ -71,25 +71,118 @@ int parseInt(StreamBuffer &in) {
 }
 
 
-void readClause(StreamBuffer &in, vector<vector<int> > &clauses) {
+// StoreSink: keeps the clause database in memory, for parse_DIMACS_CNF
+
+class StoreSink : public DIMACSSink {
+    vector<vector<int> >          &clauses;
+    vector<CardinalityConstraint> *cardinalities;
+    DIMACSSink                    *observer;
+
+    public:
+    int                           header_vars;
+
+    StoreSink(vector<vector<int> > &c, vector<CardinalityConstraint> *card, DIMACSSink *o) :
+        clauses(c), cardinalities(card), observer(o), header_vars(0) {}
+
+    void header(int vars, int clauses) {
+        if (vars > header_vars) header_vars = vars;
+        if (observer != NULL) observer->header(vars, clauses); }
+
+    void clause(const vector<int> &lits) {
+        if (observer != NULL) observer->clause(lits);
+        clauses.push_back(lits); }
+
+    void cardinality(const vector<int> &lits, int bound) {
+        if (cardinalities == NULL)
+            fprintf(stderr, "PARSE ERROR! Unexpected cardinality constraint\n"), exit(3);
+        if (observer != NULL) observer->cardinality(lits, bound);
+        cardinalities->push_back(CardinalityConstraint(lits, bound)); }
+};
+
+//-  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void readCardinality(StreamBuffer &in, vector<int> &lits, DIMACSSink &sink) {
+    // `<= k' or `>= k' after the literals
+    bool at_least = (*in == '>');
+    ++in;
+    if (*in != '=')
+        fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", *in), exit(3);
+    ++in;
+
+    int bound = parseInt(in);
+    if (at_least) {
+        for (auto &lit : lits) lit = -lit;
+        bound = lits.size() - bound;
+    }
+    sink.cardinality(lits, bound);
+}
+
+
+void readClause(StreamBuffer &in, vector<int> &newClause, DIMACSSink &sink) {
     int parsed_lit;
-    vector<int> newClause;
+    newClause.clear();
     while (true) {
+        skipWhitespace(in);
+        if (*in == '<' || *in == '>') {
+            readCardinality(in, newClause, sink);
+            return;
+        }
         parsed_lit = parseInt(in);
         if (parsed_lit == 0) break;
         newClause.push_back(parsed_lit);
     }
-    clauses.push_back(newClause);
+    sink.clause(newClause);
+}
+
+
+void readHeader(StreamBuffer &in, DIMACSSink &sink) {
+    // `p cnf <vars> <clauses>', the rest of the line is skipped
+    int counts[2] = { 0, 0 };
+    ++in;
+    skipWhitespace(in);
+    while (*in != EOF && *in != '\n' && *in != ' ' && *in != '\t') ++in;
+    for (int i = 0; i < 2; ++i) {
+        while (*in == ' ' || *in == '\t') ++in;
+        if (*in < '0' || *in > '9') break;
+        counts[i] = parseInt(in);
+    }
+    sink.header(counts[0], counts[1]);
+    skipLine(in);
 }
 
 
-void parse_DIMACS_main(StreamBuffer &in, vector<vector<int> > &clauses) {
+void parse_DIMACS_main(StreamBuffer &in, DIMACSSink &sink) {
+    vector<int> newClause;
     while (true) {
         skipWhitespace(in);
         if (*in == EOF) break;
-        else if (*in == 'c' || *in == 'p') skipLine(in);
-        else readClause(in, clauses);
+        else if (*in == 'c') skipLine(in);
+        else if (*in == 'p') readHeader(in, sink);
+        else readClause(in, newClause, sink);
+    }
+}
+
+
+FILE *open_DIMACS(const char *DIMACS_cnf_file) {
+    //gzFile in = gzopen(DIMACS_cnf_file, "rb");
+    FILE *in = fopen(DIMACS_cnf_file, "r");
+    if (in == NULL) {
+        fprintf(stderr, "ERROR! Could not open file: %s\n",
+                DIMACS_cnf_file);
+        exit(1);
+    }
+    return in;
+}
+
+
+void parse_DIMACS_stream(DIMACSSink &sink, const char *DIMACS_cnf_file) {
+    FILE *in = open_DIMACS(DIMACS_cnf_file);
+    {
+        StreamBuffer buf(in);
+        parse_DIMACS_main(buf, sink);
     }
+    //gzclose(in);
+    fclose(in);
 }
 
 
@@ -97,31 +190,48 @@ void parse_DIMACS_main(StreamBuffer &in, vector<vector<int> > &clauses) {
 void parse_DIMACS(FILE *input_stream, vector<vector<int> > &clauses)
 {
     StreamBuffer in(input_stream);
-    parse_DIMACS_main(in, clauses);
+    StoreSink sink(clauses, NULL, NULL);
+    parse_DIMACS_main(in, sink);
 }
 
 
-void parse_DIMACS_CNF(vector<vector<int> > &clauses,
+void parse_DIMACS_file(vector<vector<int> > &clauses,
+        vector<CardinalityConstraint> *cardinalities,
         int &maxVarIndex,
-        const char *DIMACS_cnf_file) {
+        const char *DIMACS_cnf_file,
+        DIMACSSink *observer) {
     unsigned int i, j;
     int candidate;
-    //gzFile in = gzopen(DIMACS_cnf_file, "rb");
-    FILE *in = fopen(DIMACS_cnf_file, "r");
-    if (in == NULL) {
-        fprintf(stderr, "ERROR! Could not open file: %s\n",
-                DIMACS_cnf_file);
-        exit(1);
-    }
-    parse_DIMACS(in, clauses);
-    //gzclose(in);
-    fclose(in);
+    StoreSink sink(clauses, cardinalities, observer);
+    parse_DIMACS_stream(sink, DIMACS_cnf_file);
 
-    maxVarIndex = 0;
+    // variables of the header which no clause uses are free
+    maxVarIndex = sink.header_vars;
     for (i = 0; i < clauses.size(); ++i)
         for (j = 0; j < clauses[i].size(); ++j) {
             candidate = abs(clauses[i][j]);
             if (candidate > maxVarIndex) maxVarIndex = candidate;
         }
+    if (cardinalities != NULL)
+        for (i = 0; i < cardinalities->size(); ++i)
+            for (j = 0; j < (*cardinalities)[i].lits.size(); ++j) {
+                candidate = abs((*cardinalities)[i].lits[j]);
+                if (candidate > maxVarIndex) maxVarIndex = candidate;
+            }
 }
 
+
+void parse_DIMACS_CNF(vector<vector<int> > &clauses,
+        int &maxVarIndex,
+        const char *DIMACS_cnf_file) {
+    parse_DIMACS_file(clauses, NULL, maxVarIndex, DIMACS_cnf_file, NULL);
+}
+
+
+void parse_DIMACS_CNF(vector<vector<int> > &clauses,
+        vector<CardinalityConstraint> &cardinalities,
+        int &maxVarIndex,
+        const char *DIMACS_cnf_file,
+        DIMACSSink *observer) {
+    parse_DIMACS_file(clauses, &cardinalities, maxVarIndex, DIMACS_cnf_file, observer);
+}
@@ -9,8 +9,12 @@
 #ifndef __PARSER_H__
 #  define __PARSER_H__
 #include <vector>
+#include <cstdio>
+#include "utils.h"
 using std::vector;
 
+class DIMACSSink;
+
 
 // parse_DIMACS_CNF
 //
@@ -28,7 +32,7 @@ using std::vector;
 //
 // // Now the `clauses' structure holds the clause database, and
 // // `maxVarIndex' is equal to the largest variable index appearing
-// // in the input CNF file.
+// // in the input CNF file, or the `p cnf' variable count if larger.
 //
 //
 // You can refer to the ith clause appearing in the CNF file using the
@@ -39,6 +43,61 @@ void parse_DIMACS_CNF(vector<vector<int> > &clauses,
 		      int &maxVarIndex,
 		      const char *DIMACS_cnf_file);
 
+// parse_DIMACS_CNF with cardinality constraints
+//
+// Also accepts cardinality constraint lines (`p cnf+' style), a list of
+// literals followed by `<=' or `>=' and a bound, without terminating 0:
+//
+//   1 -2 3 <= 1     (at most 1 of x1, -x2, x3 is true)
+//   4 5 6 7 >= 2    (at least 2 of x4 .. x7 are true)
+//
+// Every constraint is stored as at-most in `cardinalities'; `>= k' over n
+// literals becomes `<= n-k' over the negated literals.  The version
+// without `cardinalities' reports a parse error on such lines.
+//
+// If `observer' is given, every clause and constraint is also given to it
+// while parsing, e.g. FormulaHash or InstanceFeatures.
+void parse_DIMACS_CNF(vector<vector<int> > &clauses,
+		      vector<CardinalityConstraint> &cardinalities,
+		      int &maxVarIndex,
+		      const char *DIMACS_cnf_file,
+		      DIMACSSink *observer = NULL);
+
+// parse_DIMACS_stream
+//
+// Streaming version: instead of storing the clause database, every
+// clause and (at-most) cardinality constraint is given to `sink' as soon
+// as it is parsed, so memory use doesn't depend on the file size.
+class DIMACSSink {
+public:
+    virtual ~DIMACSSink() {}
+    virtual void header(int vars, int clauses) {}  // `p cnf <vars> <clauses>'
+    virtual void clause(const vector<int> &lits) = 0;
+    virtual void cardinality(const vector<int> &lits, int bound) = 0;
+};
+
+// DIMACSTee: gives every clause to all added sinks
+class DIMACSTee : public DIMACSSink {
+public:
+    void add(DIMACSSink *sink) { sinks.push_back(sink); }
+    void header(int vars, int clauses) {
+        for (auto sink : sinks) sink->header(vars, clauses); }
+    void clause(const vector<int> &lits) {
+        for (auto sink : sinks) sink->clause(lits); }
+    void cardinality(const vector<int> &lits, int bound) {
+        for (auto sink : sinks) sink->cardinality(lits, bound); }
+private:
+    vector<DIMACSSink *> sinks;
+};
+
+void parse_DIMACS_stream(DIMACSSink &sink, const char *DIMACS_cnf_file);
+
+// parse_DIMACS
+//
+// Same as parse_DIMACS_CNF, but reads from an opened stream (pipe,
+// fmemopen() buffer, ...) and doesn't compute `maxVarIndex'.
+void parse_DIMACS(FILE *input_stream, vector<vector<int> > &clauses);
+
 
 
 
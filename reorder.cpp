@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+#include "reorder.h"
+
+bool parse_reorder_method(const std::string& name, ReorderMethod& method){
+    if( name == "none" ) method = ReorderMethod::NONE;
+    else if( name == "bfs" ) method = ReorderMethod::BFS;
+    else if( name == "rcm" ) method = ReorderMethod::RCM;
+    else return false;
+    return true;
+}
+
+std::vector<int> locality_order(const vector_2d<int>& clauses,
+                                const std::vector<CardinalityConstraint>& cardinalities,
+                                int max_var_index, ReorderMethod method){
+    /*
+     * breadth first search over the incidence graph without building variable-variable edges:
+     * from a variable, every constraint containing it is visited once, and its unvisited
+     * variables are appended to the order. Variables in no constraint are visited as components of one.
+     */
+    int clause_size = clauses.size();
+    int constraint_size = clause_size + cardinalities.size();
+    auto lits_of = [&](int index) -> const std::vector<int>& {
+        return index < clause_size ? clauses[index] : cardinalities[index - clause_size].lits;
+    };
+
+    vector_2d<int> occurs(max_var_index + 1);
+    for( int index = 0; index < constraint_size; index++ ){
+        for( auto lit : lits_of(index) ){
+            occurs[std::abs(lit)].push_back(index);
+        }
+    }
+    auto by_degree = [&occurs](int a, int b){ return occurs[a].size() < occurs[b].size(); };
+
+    std::vector<int> starts(max_var_index);
+    std::iota(starts.begin(), starts.end(), 1);
+    if( method == ReorderMethod::RCM ){
+        std::stable_sort(starts.begin(), starts.end(), by_degree);
+    }
+
+    std::vector<int> order(1, 0);
+    order.reserve(max_var_index + 1);
+    std::vector<bool> visited_var(max_var_index + 1, false);
+    std::vector<bool> visited_constraint(constraint_size, false);
+
+    for( auto start : starts ){
+        if( visited_var[start] ) continue;
+
+        std::size_t component_begin = order.size();
+        visited_var[start] = true;
+        order.push_back(start);
+
+        for( std::size_t head = component_begin; head < order.size(); head++ ){
+            std::size_t found_begin = order.size();
+            for( auto index : occurs[order[head]] ){
+                if( visited_constraint[index] ) continue;
+                visited_constraint[index] = true;
+
+                for( auto lit : lits_of(index) ){
+                    int var = std::abs(lit);
+                    if( visited_var[var] ) continue;
+                    visited_var[var] = true;
+                    order.push_back(var);
+                }
+            }
+            if( method == ReorderMethod::RCM ){
+                std::stable_sort(order.begin() + found_begin, order.end(), by_degree);
+            }
+        }
+
+        if( method == ReorderMethod::RCM ){
+            std::reverse(order.begin() + component_begin, order.end());
+        }
+    }
+    return order;
+}
@@ -0,0 +1,36 @@
+#ifndef __REORDER_H__
+#define __REORDER_H__
+
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+// locality renumbering of variables
+//
+// variables are numbered in the visiting order of a breadth first search on the
+// variable-constraint incidence graph, so variables of one clause get near ids and
+// literals[] / watch lists of a propagation are near in memory.
+//
+//   BFS: components from the smallest variable id, neighbours in clause order
+//   RCM: reverse Cuthill-McKee, components from a minimum degree variable,
+//        the neighbours found from one variable in increasing degree,
+//        and each component reversed
+//
+// SatSolver::set_reorder() applies it before the first search and keeps the mapping,
+// so answer(), value() and enumerated cubes are in the original ids.
+
+enum class ReorderMethod {
+    NONE,
+    BFS,
+    RCM,
+};
+
+bool parse_reorder_method(const std::string& name, ReorderMethod& method);
+
+// order[new_var] = old_var for new_var in 1 .. max_var_index, order[0] = 0
+std::vector<int> locality_order(const vector_2d<int>& clauses,
+                                const std::vector<CardinalityConstraint>& cardinalities,
+                                int max_var_index, ReorderMethod method);
+
+#endif /* end of include guard: __REORDER_H__ */
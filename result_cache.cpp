@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "result_cache.h"
+
+std::string ResultCache::entry_path(const std::string& key) const {
+    return cache_dir + "/" + key + ".sat";
+}
+
+bool ResultCache::lookup(const std::string& key, std::string& result) const {
+    std::string path = entry_path(key);
+    std::ifstream entry(path);
+    if( !entry ) return false;
+
+    std::ostringstream content;
+    content << entry.rdbuf();
+    result = content.str();
+
+    // least recently used entry is evicted first
+    utime(path.c_str(), nullptr);
+    return !result.empty();
+}
+
+void ResultCache::store(const std::string& key, const std::string& result) const {
+    mkdir(cache_dir.c_str(), 0755);
+
+    std::string path = entry_path(key);
+    std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream entry(tmp_path);
+        entry << result;
+        if( !entry ){
+            std::remove(tmp_path.c_str());
+            return;
+        }
+    }
+
+    // the lock file holds the running size of the cache, updated with each entry
+    std::string lock_path = cache_dir + "/.lock";
+    int lock_fd = open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if( lock_fd < 0 ){
+        std::remove(tmp_path.c_str());
+        return;
+    }
+    flock(lock_fd, LOCK_EX);
+
+    struct stat info;
+    long long replaced_bytes = stat(path.c_str(), &info) == 0 ? info.st_size : 0;
+    if( std::rename(tmp_path.c_str(), path.c_str()) != 0 ){
+        std::remove(tmp_path.c_str());
+    }
+    else{
+        // no running size yet (or entries removed by hand made it wrong): scan once
+        long long total_bytes;
+        if( read_total_bytes(lock_fd, total_bytes) ){
+            total_bytes += static_cast<long long>(result.size()) - replaced_bytes;
+        }
+        else{
+            total_bytes = max_bytes + 1;
+        }
+        if( total_bytes > max_bytes || total_bytes < 0 ){
+            total_bytes = evict();
+        }
+        write_total_bytes(lock_fd, total_bytes);
+    }
+
+    flock(lock_fd, LOCK_UN);
+    close(lock_fd);
+}
+
+bool ResultCache::read_total_bytes(int lock_fd, long long& total_bytes){
+    char buf[32];
+    ssize_t size = pread(lock_fd, buf, sizeof(buf) - 1, 0);
+    if( size <= 0 ) return false;
+    buf[size] = '\0';
+
+    char* end = nullptr;
+    total_bytes = std::strtoll(buf, &end, 10);
+    return end != buf && (*end == '\n' || *end == '\0');
+}
+
+void ResultCache::write_total_bytes(int lock_fd, long long total_bytes){
+    std::string text = std::to_string(total_bytes) + "\n";
+    if( ftruncate(lock_fd, 0) != 0 ) return;
+    if( pwrite(lock_fd, text.data(), text.size(), 0) != static_cast<ssize_t>(text.size()) ){
+        ftruncate(lock_fd, 0); // read as unknown, the next store() scans
+    }
+}
+
+long long ResultCache::evict() const {
+    /* scan every entry and remove the least recently used ones, called with the lock held */
+
+    // (mtime, size, path) of every entry
+    std::vector<std::pair<time_t, std::pair<long long, std::string>>> entries;
+    long long total_bytes = 0;
+
+    DIR *dir = opendir(cache_dir.c_str());
+    if( dir != nullptr ){
+        dirent *file;
+        while( (file = readdir(dir)) != nullptr ){
+            std::string name = file->d_name;
+            if( name.size() < 4 || name.compare(name.size() - 4, 4, ".sat") != 0 ) continue;
+
+            std::string path = cache_dir + "/" + name;
+            struct stat info;
+            if( stat(path.c_str(), &info) != 0 ) continue;
+
+            entries.push_back(std::make_pair(info.st_mtime, std::make_pair(info.st_size, path)));
+            total_bytes += info.st_size;
+        }
+        closedir(dir);
+    }
+
+    std::sort(entries.begin(), entries.end());
+    for( const auto& entry : entries ){
+        if( total_bytes <= max_bytes ) break;
+        if( std::remove(entry.second.second.c_str()) == 0 ){
+            total_bytes -= entry.second.first;
+        }
+    }
+    return total_bytes;
+}
@@ -0,0 +1,36 @@
+#ifndef __RESULT_CACHE_H__
+#define __RESULT_CACHE_H__
+
+#include <string>
+
+// ResultCache
+//
+// persistent cache of solver outputs (`s ...' and `v ... 0' lines),
+// one file `<cache_dir>/<key>.sat' per formula, key is FormulaHash::hex().
+//
+//   - store() writes a temporary file and rename()s it, so a reader in
+//     another process never sees a partial entry.
+//   - lookup() touches the entry, and store() evicts least recently used
+//     entries while the cache is larger than `max_bytes'.
+//   - `<cache_dir>/.lock' is flock()ed by store() and holds the running size
+//     of the cache, so the directory is only scanned when the size may be over
+//     `max_bytes' (or unknown), not on every store().
+class ResultCache {
+public:
+    ResultCache(const std::string& cache_dir, long long max_bytes) :
+        cache_dir(cache_dir), max_bytes(max_bytes) {}
+
+    bool lookup(const std::string& key, std::string& result) const;
+    void store(const std::string& key, const std::string& result) const;
+
+private:
+    std::string entry_path(const std::string& key) const;
+    long long evict() const; // return bytes left
+    static bool read_total_bytes(int lock_fd, long long& total_bytes);
+    static void write_total_bytes(int lock_fd, long long total_bytes);
+
+    std::string cache_dir;
+    long long max_bytes;
+};
+
+#endif /* end of include guard: __RESULT_CACHE_H__ */
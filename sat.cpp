@@ -1,24 +1,214 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <deque>
 #include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <atomic>
+#include <csignal>
+#include <memory>
+
+#include <sys/resource.h>
 
 #include "parser.h"
 #include "utils.h"
 #include "sat_solver.h"
+#include "server.h"
+#include "formula_hash.h"
+#include "result_cache.h"
+#include "model_checker.h"
+#include "instance_features.h"
+#include "config_selector.h"
+#include "trace.h"
+#include "checkpoint.h"
 
 void print_clauses(std::vector<Clause> clauses);
-void print_sat_solution(std::ostream& output_stream, std::vector<BoolVal>& answer);
+void print_usage();
+int verify_answer_file(const std::string& input_name, const std::string& answer_name);
+int enumerate_models(SatSolver& solver, const std::vector<int>& projection, bool count_only,
+                     std::ostream& output_stream, bool show_stats);
+std::vector<int> parse_var_list(const std::string& text);
+void print_stats(std::ostream& os, const SatSolver& solver, double parse_seconds, double solve_seconds);
+void print_memory_usage(std::ostream& os, const SatSolver& solver);
+bool cached_result_valid(const std::string& result, const std::vector<Clause>& clauses,
+                         const std::vector<CardinalityConstraint>& cardinalities, int max_var_index);
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_seconds(Clock::time_point start){
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// SIGUSR1: checkpoint, SIGINT / SIGTERM: checkpoint and stop the search
+static CheckpointWriter* checkpoint_writer = nullptr;
+static std::atomic<bool> stop_solve(false);
+
+static void checkpoint_signal(int signal_number){
+    if( checkpoint_writer ) checkpoint_writer->request();
+    if( signal_number != SIGUSR1 ) stop_solve = true;
+}
 
 int main(int argc, char *argv[]){
-    
-    if( argc != 2 ){
+
+    std::string input_name;
+    std::string answer_name;
+    bool verify = false;
+    std::string serve_socket;
+    int serve_workers = 4;
+    bool show_stats = false;
+    bool search_log = false;
+    bool detect_amo = false;
+    SearchEngine engine = SearchEngine::DPLL;
+    bool show_features = false;
+    bool auto_config = false;
+    std::string config_name;
+    std::string selector_table;
+    std::string trace_path;
+    bool all_models = false;
+    bool count_only = false;
+    std::vector<int> projection;
+    std::string checkpoint_path;
+    double checkpoint_interval = 600;
+    std::string resume_path;
+    ReorderMethod reorder_method = ReorderMethod::NONE;
+    long long conflict_budget = -1;
+    std::string cache_dir;
+    long long cache_size_mb = 1024;
+    long long mem_limit_mb = 0;
+
+    for( int i = 1; i < argc; i++ ){
+        std::string arg = argv[i];
+
+        if( arg == "--serve" && i + 1 < argc ){
+            serve_socket = argv[++i];
+        }
+        else if( arg == "--workers" && i + 1 < argc ){
+            serve_workers = std::atoi(argv[++i]);
+        }
+        else if( arg == "--detect-amo" ){
+            detect_amo = true;
+        }
+        else if( arg == "--engine" && i + 1 < argc ){
+            std::string name = argv[++i];
+            if( name == "dpll" ) engine = SearchEngine::DPLL;
+            else if( name == "lookahead" ) engine = SearchEngine::LOOKAHEAD;
+            else{
+                std::cerr << "unknown engine: " << name << std::endl;
+                std::exit(1);
+            }
+        }
+        else if( arg == "--cache" && i + 1 < argc ){
+            cache_dir = argv[++i];
+        }
+        else if( arg == "--cache-size" && i + 1 < argc ){
+            cache_size_mb = std::atoll(argv[++i]);
+        }
+        else if( arg == "--mem-limit" && i + 1 < argc ){
+            mem_limit_mb = std::atoll(argv[++i]);
+        }
+        else if( arg == "--features" ){
+            show_features = true;
+        }
+        else if( arg == "--auto" ){
+            auto_config = true;
+        }
+        else if( arg == "--config" && i + 1 < argc ){
+            config_name = argv[++i];
+        }
+        else if( arg == "--selector-table" && i + 1 < argc ){
+            selector_table = argv[++i];
+            auto_config = true;
+        }
+        else if( arg == "--trace" && i + 1 < argc ){
+            trace_path = argv[++i];
+        }
+        else if( arg == "--all" ){
+            all_models = true;
+        }
+        else if( arg == "--count" ){
+            all_models = true;
+            count_only = true;
+        }
+        else if( arg == "--project" && i + 1 < argc ){
+            projection = parse_var_list(argv[++i]);
+            all_models = true;
+        }
+        else if( arg == "--checkpoint" && i + 1 < argc ){
+            checkpoint_path = argv[++i];
+        }
+        else if( arg == "--checkpoint-interval" && i + 1 < argc ){
+            checkpoint_interval = std::atof(argv[++i]);
+        }
+        else if( arg == "--resume" && i + 1 < argc ){
+            resume_path = argv[++i];
+        }
+        else if( arg == "--reorder" && i + 1 < argc ){
+            if( !parse_reorder_method(argv[++i], reorder_method) ){
+                std::cerr << "unknown reorder method: " << argv[i] << std::endl;
+                std::exit(1);
+            }
+        }
+        else if( arg == "--verify" ){
+            verify = true;
+        }
+        else if( arg == "--stats" ){
+            show_stats = true;
+        }
+        else if( arg == "--search-log" ){
+            search_log = true;
+        }
+        else if( arg == "--conflicts" && i + 1 < argc ){
+            conflict_budget = std::atoll(argv[++i]);
+        }
+        else if( arg.size() > 2 && arg.substr(0, 2) == "--" ){
+            std::cerr << "unknown option: " << arg << std::endl;
+            print_usage();
+            std::exit(1);
+        }
+        else if( input_name.empty() ){
+            input_name = arg;
+        }
+        else if( verify && answer_name.empty() ){
+            answer_name = arg;
+        }
+        else{
+            print_usage();
+            std::exit(1);
+        }
+    }
+
+    // dumped at exit
+    if( !trace_path.empty() ){
+        trace_start(trace_path);
+    }
+
+    if( !serve_socket.empty() ){
+        return serve(serve_socket, serve_workers);
+    }
+
+    if( input_name.empty() ){
         std::cerr << "invalid number of parameter." << std::endl;
-        std::cerr << "./yasat [input.cnf]" << std::endl;
+        print_usage();
+        std::exit(1);
+    }
+
+    if( !answer_name.empty() ){
+        return verify_answer_file(input_name, answer_name);
+    }
+
+    // the cache keeps results of single solves only
+    if( all_models ){
+        cache_dir.clear();
+    }
+    if( all_models && (!checkpoint_path.empty() || !resume_path.empty()) ){
+        std::cerr << "--checkpoint and --resume can't be used with --all / --count" << std::endl;
         std::exit(1);
     }
-    std::string input_name = argv[1];
+
     std::string output_name = input_name.substr(0, input_name.size()-4);
     output_name += ".sat";
 
@@ -29,59 +219,207 @@ int main(int argc, char *argv[]){
     output_stream.open(output_name, std::ios::out);
 #endif
 
+    Clock::time_point parse_start = Clock::now();
     vector_2d<int> input_clauses;
+    std::vector<CardinalityConstraint> cardinalities;
     int max_var_index;
-    parse_DIMACS_CNF(input_clauses, max_var_index, input_name.c_str());
+    FormulaHash formula_hash;
+    InstanceFeatures features;
+    DIMACSTee parse_observers;
+    if( !cache_dir.empty() || !checkpoint_path.empty() || !resume_path.empty() ) parse_observers.add(&formula_hash);
+    if( show_features || auto_config ) parse_observers.add(&features);
+
+    {
+        TRACE_SCOPE("parse");
+        parse_DIMACS_CNF(input_clauses, cardinalities, max_var_index, input_name.c_str(), &parse_observers);
+    }
+    double parse_seconds = elapsed_seconds(parse_start);
+
+    if( show_features ){
+        features.print(std::cerr);
+    }
 
-    std::vector<Clause> clauses(input_clauses);
+    // solver configuration: --config, selected by features (--auto), or flags
+    SolverConfig config = { "flags", detect_amo, engine };
+    if( !config_name.empty() ){
+        const SolverConfig* named_config = find_solver_config(config_name);
+        if( named_config == nullptr ){
+            std::cerr << "unknown config: " << config_name << std::endl;
+            std::exit(1);
+        }
+        config = *named_config;
+    }
+    else if( auto_config ){
+        ConfigSelector selector;
+        if( !selector_table.empty() && !selector.load_table(selector_table) ){
+            std::cerr << "ERROR! Could not load selector table: " << selector_table << std::endl;
+            std::exit(1);
+        }
+        double distance;
+        config = selector.select(features.values(), distance);
+        std::cerr << "c selector_config = " << config.name << std::endl;
+        std::cerr << "c selector_distance = " << distance << std::endl;
+    }
+    // the search position of a checkpoint is a DPLL decision stack
+    if( config.engine == SearchEngine::LOOKAHEAD && (!checkpoint_path.empty() || !resume_path.empty()) ){
+        std::cerr << "c lookahead engine has no checkpoints, dpll is used" << std::endl;
+        config.engine = SearchEngine::DPLL;
+    }
+
+    std::vector<Clause> clauses(std::move(input_clauses));
 #ifdef DEBUG
     // print_clauses(clauses);
 #endif
 
-    SatSolver solver;
-    solver.set_clauses(clauses, max_var_index);
-    // Solve SAT problem
-    bool is_sat = solver.solve();
-
-    if( is_sat ){
-        output_stream << "s SATISFIABLE" << std::endl;
+    // same formula was solved before: check the cached model, then reuse it
+    ResultCache result_cache(cache_dir, cache_size_mb * 1024 * 1024);
+    if( !cache_dir.empty() ){
+        TRACE_SCOPE("cache_lookup");
+        std::string cached_result;
+        bool is_hit = result_cache.lookup(formula_hash.hex(), cached_result) &&
+                      cached_result_valid(cached_result, clauses, cardinalities, max_var_index);
+        if( show_stats ){
+            std::cerr << "c cache_key = " << formula_hash.hex() << std::endl;
+            std::cerr << "c cache_hit = " << is_hit << std::endl;
+        }
+        if( is_hit ){
+            output_stream << cached_result;
+            return 0;
+        }
+    }
 
-        std::vector<BoolVal> answer = solver.answer();
-        print_sat_solution(output_stream, answer);
+    Clock::time_point solve_start = Clock::now();
+    SatSolver solver;
+    std::size_t solver_memory_limit = 0;
+    if( mem_limit_mb > 0 ){
+        // the input kept for --verify and --stats counts against the limit too
+        std::size_t limit = mem_limit_mb * 1024 * 1024;
+        std::size_t input_bytes = memory_bytes(clauses) + memory_bytes(cardinalities);
+        solver_memory_limit = input_bytes < limit ? limit - input_bytes : 1;
+    }
+    if( !resume_path.empty() ){
+        // simplified clauses and search position of the checkpoint
+        std::string checkpoint_key;
+        if( !load_checkpoint(resume_path, checkpoint_key, solver) ){
+            std::cerr << "ERROR! Could not load checkpoint: " << resume_path << std::endl;
+            std::exit(1);
+        }
+        if( checkpoint_key != formula_hash.hex() ){
+            std::cerr << "ERROR! Checkpoint " << resume_path << " is not of " << input_name << std::endl;
+            std::exit(1);
+        }
     }
     else{
-        output_stream << "s UNSATISFIABLE" << std::endl;
+        // set_clauses() copies the input, stop before it when the setup can't fit
+        solver.set_memory_limit(solver_memory_limit);
+        if( solver.check_memory_estimate(setup_memory_estimate(clauses, cardinalities, max_var_index)) ){
+            output_stream << "s UNKNOWN" << std::endl;
+            print_memory_usage(std::cerr, solver);
+            return 0;
+        }
+        solver.set_clauses(clauses, max_var_index);
+        for( const auto& constraint : cardinalities ){
+            solver.add_at_most(constraint.lits, constraint.bound);
+        }
+        config.apply(solver);
+        solver.set_reorder(reorder_method);
     }
+    solver.set_conflict_budget(conflict_budget);
+    solver.set_statistics(show_stats);
+    solver.set_memory_limit(solver_memory_limit);
+    solver.set_search_log(search_log);
 
-    return 0;
-}
+    if( all_models ){
+        return enumerate_models(solver, projection, count_only, output_stream, show_stats);
+    }
 
-void print_sat_solution(std::ostream& output_stream, std::vector<BoolVal>& answer){
-    /* print answer of SAT solution.
-     *
-     *   the format of (x1=0, x2=1, x3=0) is
-     *   v -1 2 -3 0
-     */
+    // checkpoints in background, stopped before the solver is used again
+    std::unique_ptr<CheckpointWriter> writer;
+    if( !checkpoint_path.empty() ){
+        writer.reset(new CheckpointWriter(checkpoint_path, formula_hash.hex(), checkpoint_interval));
+        writer->attach(solver);
+        checkpoint_writer = writer.get();
+        solver.set_terminate_flag(&stop_solve);
+        std::signal(SIGUSR1, checkpoint_signal);
+        std::signal(SIGINT, checkpoint_signal);
+        std::signal(SIGTERM, checkpoint_signal);
+    }
 
-    output_stream << "v ";
+    // Solve SAT problem
+    BoolVal is_sat = resume_path.empty() ? solver.solve_limited() : solver.resume_limited();
 
-    for( int i = 0; i < answer.size(); i++ ){
-        if( answer[i] == BoolVal::TRUE ){
-            output_stream << i + 1 << " ";
+    long long checkpoint_count = 0, checkpoint_failures = 0;
+    if( writer ){
+        std::signal(SIGUSR1, SIG_DFL);
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        checkpoint_writer = nullptr;
+        writer->stop();
+        checkpoint_count = writer->written();
+        checkpoint_failures = writer->failed();
+    }
+    double solve_seconds = elapsed_seconds(solve_start);
+
+    if( show_stats ){
+        std::cerr << "c clauses = " << clauses.size() << std::endl;
+        std::cerr << "c cardinality_constraints = " << cardinalities.size() << std::endl;
+        std::cerr << "c memory_input_bytes = " << memory_bytes(clauses) + memory_bytes(cardinalities) << std::endl;
+        print_stats(std::cerr, solver, parse_seconds, solve_seconds);
+        if( !checkpoint_path.empty() ){
+            std::cerr << "c checkpoints = " << checkpoint_count << std::endl;
         }
-        else if( answer[i] == BoolVal::FALSE ){
-            output_stream << "-" << i + 1 << " ";
+    }
+    else if( solver.memory_exhausted ){
+        print_memory_usage(std::cerr, solver);
+    }
+    // a failed write is reported by the writer, the count also without --stats
+    if( checkpoint_failures > 0 ){
+        std::cerr << "c checkpoint_failures = " << checkpoint_failures << std::endl;
+    }
+
+    std::ostringstream result_stream;
+    {
+        TRACE_SCOPE("output");
+        if( is_sat == BoolVal::TRUE ){
+            result_stream << "s SATISFIABLE" << std::endl;
+
+            std::vector<BoolVal> answer = solver.answer();
+            print_sat_solution(result_stream, answer);
+        }
+        else if( is_sat == BoolVal::FALSE ){
+            result_stream << "s UNSATISFIABLE" << std::endl;
         }
         else{
-            // not assigned literal: [don't care condition or error?]
-#ifdef DEBUG
-            output_stream << "@" << i + 1 << " ";
-#else
-            output_stream << i + 1 << " ";
-#endif
+            result_stream << "s UNKNOWN" << std::endl;
         }
+        output_stream << result_stream.str();
     }
-    output_stream << "0" << std::endl;
+
+    // check in-memory answer against the input formula
+    int exit_code = 0;
+    if( verify && is_sat == BoolVal::TRUE ){
+        TRACE_SCOPE("verify");
+        ModelChecker checker;
+        checker.set_model(solver.answer());
+        checker.set_var_range(max_var_index);
+        for( const auto& clause : clauses ){
+            checker.clause(clause);
+        }
+        for( const auto& constraint : cardinalities ){
+            checker.cardinality(constraint.lits, constraint.bound);
+        }
+        checker.print_report(std::cerr);
+        if( !checker.is_ok() ){
+            exit_code = 2;
+        }
+    }
+
+    if( !cache_dir.empty() && is_sat != BoolVal::NOT_ASSIGNED && exit_code == 0 ){
+        TRACE_SCOPE("cache_store");
+        result_cache.store(formula_hash.hex(), result_stream.str());
+    }
+
+    return exit_code;
 }
 
 void print_clauses(std::vector<Clause> clauses){
@@ -93,3 +431,181 @@ void print_clauses(std::vector<Clause> clauses){
         std::cout << std::endl;
     }
 }
+
+void print_stats(std::ostream& os, const SatSolver& solver, double parse_seconds, double solve_seconds){
+    /* statistics in `c key = value' lines */
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    os << "c variables = " << solver.max_var_index << std::endl;
+    os << "c parse_seconds = " << parse_seconds << std::endl;
+    os << "c solve_seconds = " << solve_seconds << std::endl;
+    os << "c decisions = " << solver.decisions << std::endl;
+    os << "c propagations = " << solver.propagations << std::endl;
+    os << "c conflicts = " << solver.conflicts << std::endl;
+    if( solver.engine == SearchEngine::LOOKAHEAD ){
+        os << "c lookaheads = " << solver.lookahead_stats.lookaheads << std::endl;
+        os << "c failed_literals = " << solver.lookahead_stats.failed_literals << std::endl;
+        os << "c double_lookaheads = " << solver.lookahead_stats.double_lookaheads << std::endl;
+        os << "c learned_implications = " << solver.lookahead_stats.learned_implications << std::endl;
+    }
+    os << "c solver_clauses = " << solver.all_clauses.size() << std::endl;
+    os << "c solver_cardinality_constraints = " << solver.all_cardinalities.size() << std::endl;
+    if( solve_seconds > 0 ){
+        os << "c propagations_per_second = " << solver.propagations / solve_seconds << std::endl;
+    }
+    os << "c max_rss_kb = " << usage.ru_maxrss << std::endl;
+    print_memory_usage(os, solver);
+}
+
+void print_memory_usage(std::ostream& os, const SatSolver& solver){
+    /* bytes of each solver structure, at the limit when the search was stopped by it */
+    MemoryUsage memory = solver.memory_exhausted ? solver.memory_at_limit : solver.memory_usage();
+    os << "c memory_clauses_bytes = " << memory.clauses << std::endl;
+    os << "c memory_watches_bytes = " << memory.watches << std::endl;
+    os << "c memory_cardinality_bytes = " << memory.cardinality << std::endl;
+    os << "c memory_undo_bytes = " << memory.undo << std::endl;
+    os << "c memory_other_bytes = " << memory.other << std::endl;
+    os << "c memory_solver_bytes = " << memory.total() << std::endl;
+    if( memory.estimated ){
+        os << "c memory_estimated = 1" << std::endl;
+    }
+    if( solver.memory_limit > 0 ){
+        os << "c memory_limit_bytes = " << solver.memory_limit << std::endl;
+        os << "c memory_compactions = " << solver.compactions << std::endl;
+        os << "c memory_exhausted = " << solver.memory_exhausted << std::endl;
+    }
+}
+
+bool cached_result_valid(const std::string& result, const std::vector<Clause>& clauses,
+                         const std::vector<CardinalityConstraint>& cardinalities, int max_var_index){
+    /*
+     * UNSAT result can't be checked cheaply, trust the hash.
+     * SAT result is checked against every clause and constraint.
+     */
+    std::istringstream result_stream(result);
+    ModelChecker checker;
+    BoolVal status = checker.read_model(result_stream);
+
+    if( status == BoolVal::FALSE ) return true;
+    if( status != BoolVal::TRUE ) return false;
+
+    checker.set_var_range(max_var_index);
+    if( !checker.model_ok() ) return false;
+    for( const auto& clause : clauses ){
+        checker.clause(clause);
+        if( !checker.is_ok() ) return false;
+    }
+    for( const auto& constraint : cardinalities ){
+        checker.cardinality(constraint.lits, constraint.bound);
+    }
+    return checker.is_ok();
+}
+
+int verify_answer_file(const std::string& input_name, const std::string& answer_name){
+    /*
+     * stream the CNF file and check every clause against the answer,
+     * memory is the model only.
+     *   return 0: OK or UNSAT answer (not checked), 2: FAILED
+     */
+    std::ifstream answer_stream(answer_name);
+    if( !answer_stream ){
+        std::cerr << "ERROR! Could not open file: " << answer_name << std::endl;
+        return 1;
+    }
+
+    ModelChecker checker;
+    BoolVal status = checker.read_model(answer_stream);
+    if( status == BoolVal::FALSE ){
+        std::cerr << "c verify = UNSAT answer is not checked" << std::endl;
+        return 0;
+    }
+    if( status != BoolVal::TRUE ){
+        std::cerr << "c verify = FAILED, no s SATISFIABLE / s UNSATISFIABLE line" << std::endl;
+        return 2;
+    }
+
+    parse_DIMACS_stream(checker, input_name.c_str());
+    checker.print_report(std::cerr);
+    return checker.is_ok() ? 0 : 2;
+}
+
+int enumerate_models(SatSolver& solver, const std::vector<int>& projection, bool count_only,
+                     std::ostream& output_stream, bool show_stats){
+    /*
+     * stream every model as a cube `v <lits> 0', variables not in the cube are don't care:
+     *
+     *   s SATISFIABLE
+     *   v 1 -3 0
+     *   v -1 2 0
+     *   c models = 6
+     *
+     * --count prints `s mc <models>' only. A stopped enumeration is `s UNKNOWN' and
+     * the printed count is a lower bound.
+     */
+    ModelCount models;
+    long long cubes = 0;
+    Clock::time_point start = Clock::now();
+    BoolVal result = solver.enumerate(projection, [&](const std::vector<int>& cube){
+        models.add_power_of_two(solver.projection_vars.size() - cube.size());
+        cubes += 1;
+        if( count_only ) return true;
+
+        if( cubes == 1 ) output_stream << "s SATISFIABLE\n";
+        output_stream << "v ";
+        for( auto lit : cube ){
+            output_stream << lit << " ";
+        }
+        output_stream << "0\n";
+        return true;
+    });
+    double seconds = elapsed_seconds(start);
+
+    if( count_only ){
+        output_stream << (result == BoolVal::FALSE ? "s mc " : "s UNKNOWN\nc models >= ") << models.str() << std::endl;
+    }
+    else{
+        if( result != BoolVal::FALSE ) output_stream << "s UNKNOWN" << std::endl;
+        else if( cubes == 0 ) output_stream << "s UNSATISFIABLE" << std::endl;
+        output_stream << "c models " << (result == BoolVal::FALSE ? "= " : ">= ") << models.str() << std::endl;
+    }
+
+    if( !show_stats && solver.memory_exhausted ){
+        print_memory_usage(std::cerr, solver);
+    }
+    if( show_stats ){
+        print_stats(std::cerr, solver, 0, seconds);
+        std::cerr << "c cubes = " << cubes << std::endl;
+        std::cerr << "c models = " << models.str() << std::endl;
+        if( seconds > 0 ){
+            std::cerr << "c cubes_per_second = " << cubes / seconds << std::endl;
+            std::cerr << "c models_per_second = " << models.approx() / seconds << std::endl;
+        }
+    }
+    return 0;
+}
+
+std::vector<int> parse_var_list(const std::string& text){
+    /* `1,2,5' or `1 2 5' */
+    std::string spaced(text);
+    std::replace(spaced.begin(), spaced.end(), ',', ' ');
+
+    std::istringstream tokens(spaced);
+    std::vector<int> vars;
+    int var;
+    while( tokens >> var ){
+        vars.push_back(std::abs(var));
+    }
+    return vars;
+}
+
+void print_usage(){
+    std::cerr << "./yasat [--stats] [--conflicts N] [--detect-amo] [--cache DIR [--cache-size MB]]" << std::endl;
+    std::cerr << "        [--features] [--auto] [--selector-table FILE] [--config NAME] [--trace FILE]" << std::endl;
+    std::cerr << "        [--reorder none|bfs|rcm] [--engine dpll|lookahead] [--search-log] [input.cnf]" << std::endl;
+    std::cerr << "./yasat [--mem-limit MB] input.cnf" << std::endl;
+    std::cerr << "./yasat [--checkpoint FILE [--checkpoint-interval SEC]] [--resume FILE] input.cnf" << std::endl;
+    std::cerr << "./yasat [--all | --count] [--project 1,2,...] input.cnf" << std::endl;
+    std::cerr << "./yasat --verify input.cnf [answer.sat]" << std::endl;
+    std::cerr << "./yasat --serve <socket> [--workers N] [--trace FILE]" << std::endl;
+}
@@ -1,7 +1,11 @@
+#include <algorithm>
 #include <cassert>
+#include <unordered_map>
 #include <iostream>
 
 #include "sat_solver.h"
+#include "search_policy.h"
+#include "trace.h"
 #include "utils.h"
 
 std::ostream& operator << (std::ostream& os, const BoolVal& value){
@@ -11,51 +15,641 @@ std::ostream& operator << (std::ostream& os, const BoolVal& value){
     return os;
 }
 
+void print_sat_solution(std::ostream& output_stream, const std::vector<BoolVal>& answer){
+    /* print answer of SAT solution.
+     *
+     *   the format of (x1=0, x2=1, x3=0) is
+     *   v -1 2 -3 0
+     */
+
+    output_stream << "v ";
+
+    for( int i = 0; i < static_cast<int>(answer.size()); i++ ){
+        if( answer[i] == BoolVal::TRUE ){
+            output_stream << i + 1 << " ";
+        }
+        else if( answer[i] == BoolVal::FALSE ){
+            output_stream << "-" << i + 1 << " ";
+        }
+        else{
+            // not assigned literal: [don't care condition or error?]
+#ifdef DEBUG
+            output_stream << "@" << i + 1 << " ";
+#else
+            output_stream << i + 1 << " ";
+#endif
+        }
+    }
+    output_stream << "0" << std::endl;
+}
+
 // SatSolver
 void SatSolver::set_clauses(const std::vector<Clause>& clauses, int max_var_index){
     all_clauses = clauses;
+    root_units.clear();
+    original_of_var.clear();
+    var_of_original.clear();
     this->max_var_index = max_var_index;
     clear_and_resize();
 }
 
+void SatSolver::add_lit(int lit){
+    if( lit == 0 ){
+        all_clauses.push_back(adding_clause);
+        adding_clause.clear();
+        return;
+    }
+
+    adding_clause.push_back(internal_lit(lit));
+    if( std::abs(lit) > max_var_index ){
+        max_var_index = std::abs(lit);
+    }
+}
+
+void SatSolver::assume(int lit){
+    assumptions.push_back(internal_lit(lit));
+    if( std::abs(lit) > max_var_index ){
+        max_var_index = std::abs(lit);
+    }
+}
+
+void SatSolver::add_at_most(const std::vector<int>& lits, int bound){
+    all_cardinalities.push_back(CardinalityConstraint(lits, bound));
+    for( auto& lit : all_cardinalities.back().lits ){
+        if( std::abs(lit) > max_var_index ){
+            max_var_index = std::abs(lit);
+        }
+        lit = internal_lit(lit);
+    }
+}
+
+void SatSolver::add_at_least(const std::vector<int>& lits, int bound){
+    // at least k of n literals are true <=> at most n-k of negated literals are true
+    std::vector<int> negated_lits;
+    for( auto lit : lits ){
+        negated_lits.push_back(-lit);
+    }
+    add_at_most(negated_lits, lits.size() - bound);
+}
+
 bool SatSolver::solve(){
-    remove_unit_clause_init();
+    return solve_limited() == BoolVal::TRUE;
+}
+
+BoolVal SatSolver::solve_limited(){
+    TRACE_SCOPE("solve_limited");
+
+    // solve() can be called again after more clauses are added,
+    // so put back the unit clauses which were removed by last solve().
+    for( auto lit : root_units ){
+        all_clauses.push_back(Clause(1, lit));
+    }
+    root_units.clear();
+    if( reorder_method != ReorderMethod::NONE && original_of_var.empty() ){
+        TRACE_SCOPE("reorder_variables");
+        reorder_variables();
+    }
+    decisions = 0;
+    propagations = 0;
+    conflicts = 0;
+    lookahead_stats = LookaheadStats();
+    memory_exhausted = false;
+    // the setup before the search is the peak, stop before it
+    if( check_memory_estimate(setup_memory_estimate(all_clauses, all_cardinalities, max_var_index)) ){
+        assumptions.clear();
+        return BoolVal::NOT_ASSIGNED;
+    }
+    clear_and_resize();
+
+    BoolVal result = BoolVal::FALSE;
+    bool is_simplified;
+    {
+        TRACE_SCOPE("remove_unit_clause_init");
+        is_simplified = remove_unit_clause_init();
+    }
+    if( is_simplified ){
+        if( detect_amo ){
+            TRACE_SCOPE("detect_at_most_one");
+            detect_at_most_one();
+        }
+        {
+            TRACE_SCOPE("add_2_lit_watch_each_clause");
+            add_2_lit_watch_each_clause();
+            add_cardinality_occurs();
+        }
+        TRACE_SCOPE("search");
+        reset_decision_order();
+        if( check_memory() ){
+            result = BoolVal::NOT_ASSIGNED;
+        }
+        else{
+            result = engine == SearchEngine::LOOKAHEAD ? lookahead_search() : DPLL_backtrack();
+        }
+    }
+
+    // assumptions are only valid for one solve()
+    assumptions.clear();
+    return result;
+}
+
+BoolVal SatSolver::enumerate(const std::vector<int>& projection,
+                             const std::function<bool(const std::vector<int>&)>& on_model){
+    /*
+     * all models in one search, solver state is kept between models:
+     *
+     *   1. DPLL_backtrack() finds a model, projection variables are decided first
+     *   2. shrink_model() drops projection literals which no clause needs
+     *   3. block_model() adds the negated cube as clause and inverts the last decision
+     *   4. DPLL_backtrack(true) continues the chronological search, until no decision is left
+     *
+     * blocking clauses are removed at the end, so solve() works as before.
+     */
+    TRACE_SCOPE("enumerate");
+
+    for( auto lit : root_units ){
+        all_clauses.push_back(Clause(1, lit));
+    }
+    root_units.clear();
+    // a projected variable in no clause is free, each one doubles the count.
+    // internal_var() keeps variables beyond a reordering as they are
+    for( auto original : projection ){
+        max_var_index = std::max(max_var_index, original);
+    }
+    if( reorder_method != ReorderMethod::NONE && original_of_var.empty() ){
+        reorder_variables();
+    }
+    decisions = 0;
+    propagations = 0;
+    conflicts = 0;
+    memory_exhausted = false;
+    if( check_memory_estimate(setup_memory_estimate(all_clauses, all_cardinalities, max_var_index)) ){
+        return BoolVal::NOT_ASSIGNED;
+    }
+    clear_and_resize();
+
+    projection_vars.clear();
+    is_projected.assign(max_var_index + 1, projection.empty());
+    for( auto original : projection ){
+        if( original < 1 ) continue;
+        int var = internal_var(original);
+        if( !is_projected[var] ){
+            is_projected[var] = true;
+            projection_vars.push_back(var);
+        }
+    }
+    if( projection.empty() ){
+        for( int original = 1; original <= max_var_index; original++ ) projection_vars.push_back(internal_var(original));
+    }
+
+    // projection first, so the search below a projected model only looks for one witness
+    decision_order.assign(1, 0);
+    decision_order.insert(decision_order.end(), projection_vars.begin(), projection_vars.end());
+    for( int original = 1; original <= max_var_index; original++ ){
+        if( !is_projected[internal_var(original)] ) decision_order.push_back(internal_var(original));
+    }
+    decision_position.assign(max_var_index + 1, 0);
+    for( int position = 1; position <= max_var_index; position++ ){
+        decision_position[decision_order[position]] = position;
+    }
+
+    BoolVal result = BoolVal::FALSE;
+    int input_clause_size = 0;
+    if( remove_unit_clause_init() ){
+        if( detect_amo ){
+            detect_at_most_one();
+        }
+        add_2_lit_watch_each_clause();
+        add_cardinality_occurs();
+        input_clause_size = all_clauses.size();
+
+        std::vector<int> cube, original_cube;
+        result = check_memory() ? BoolVal::NOT_ASSIGNED : DPLL_backtrack();
+        while( result == BoolVal::TRUE ){
+            shrink_model(cube);
+            original_cube.clear();
+            for( auto lit : cube ) original_cube.push_back(original_lit(lit));
+            if( !on_model(original_cube) ){
+                result = BoolVal::NOT_ASSIGNED;
+            }
+            else if( !block_model(cube) ){
+                result = BoolVal::FALSE;
+            }
+            else if( memory_over_limit() ){
+                result = BoolVal::NOT_ASSIGNED; // blocking clauses grow with the models
+            }
+            else{
+                result = DPLL_backtrack(true);
+            }
+        }
+    }
+
+    all_clauses.resize(input_clause_size);
+    reset_decision_order();
+    assumptions.clear();
+    return result;
+}
+
+void SatSolver::shrink_model(std::vector<int>& cube){
+    /*
+     * keep a projection literal only when some constraint needs it, so every
+     * assignment of the dropped variables is a model too (other variables keep their values):
+     *
+     *   clause:      needs one kept true literal, or a true literal of a non-projection variable.
+     *                1st pass keeps the only true projection literal of a clause,
+     *                2nd pass keeps the first true literal of clauses not covered yet.
+     *   cardinality: dropped variables may become true, at most `bound - true count' of them.
+     *   root units:  always kept, simplified clauses don't show them.
+     */
+    shrink_required.assign(max_var_index + 1, false);
+    for( auto lit : root_units ){
+        if( is_projected[std::abs(lit)] ) shrink_required[std::abs(lit)] = true;
+    }
+
+    for( int pass = 0; pass < 2; pass++ ){
+        for( const auto& clause : all_clauses ){
+            int candidate = 0;
+            bool is_covered = false;
+            for( auto lit : clause ){
+                int var = std::abs(lit);
+                if( literals[var].value != to_bool_val(lit > 0) ) continue;
+
+                if( !is_projected[var] || shrink_required[var] ){
+                    is_covered = true;
+                    break;
+                }
+                if( candidate == 0 ){
+                    candidate = var;
+                }
+                else if( candidate != var && pass == 0 ){
+                    is_covered = true; // more than one true literal, decided in 2nd pass
+                    break;
+                }
+            }
+            if( !is_covered && candidate != 0 ) shrink_required[candidate] = true;
+        }
+    }
+
+    for( const auto& constraint : all_cardinalities ){
+        int slack = constraint.bound;
+        for( auto lit : constraint.lits ){
+            if( literals[std::abs(lit)].value == to_bool_val(lit > 0) ) slack -= 1;
+        }
+        for( auto lit : constraint.lits ){
+            int var = std::abs(lit);
+            if( literals[var].value == to_bool_val(lit > 0) || !is_projected[var] || shrink_required[var] ) continue;
+            if( slack > 0 ) slack -= 1;
+            else shrink_required[var] = true;
+        }
+    }
+
+    cube.clear();
+    for( auto var : projection_vars ){
+        if( shrink_required[var] ){
+            cube.push_back(literals[var].value == BoolVal::TRUE ? var : -var);
+        }
+    }
+}
+
+bool SatSolver::block_model(const std::vector<int>& cube){
+    /*
+     * add the blocking clause (-cube) to the running search, and backtrack until it is not false.
+     * it is watched on non-false literals, a unit blocking clause is implied when its
+     * watched literal is assigned false later, as in update_literal().
+     *   return false: no decision left to invert, all models are found
+     */
+    if( cube.empty() ) return false; // every projected assignment is a model
+
+    Clause blocking;
+    for( auto lit : cube ){
+        blocking.push_back(-lit);
+    }
+    if( blocking.size() == 1 ){
+        blocking.push_back(blocking[0]); // 2 literal watching needs 2 positions
+    }
+
+    int clause_index = all_clauses.size();
+    all_clauses.push_back(blocking);
+    sat_clauses.push_back(false);
+    clause_watched_2_lit.push_back(LiteralIndexPair());
+
+    int size = blocking.size();
+    while( backtrack_next() ){
+        int first = -1, second = -1;
+        for( int lit_index = 0; lit_index < size && second < 0; lit_index++ ){
+            if( literal_truth_in_clause(clause_index, lit_index) == BoolVal::FALSE ) continue;
+            if( first < 0 ) first = lit_index;
+            else second = lit_index;
+        }
+
+        if( first >= 0 ){
+            if( second < 0 ) second = first == 0 ? 1 : 0;
+            add_literal_watch(clause_index, first, 0);
+            add_literal_watch(clause_index, second, 1);
+            return true;
+        }
+        // still false below the inverted decision, same as a conflict
+        conflicts += 1;
+    }
+    return false;
+}
+
+BoolVal SatSolver::resume_limited(){
+    /*
+     * load_checkpoint() gives the simplified clause database, root_units, statistics and
+     * decision_literals. Imply all decisions but the last again, which rebuilds the trail,
+     * then DPLL_backtrack(true) implies the last one and continues the search.
+     */
+    TRACE_SCOPE("resume_limited");
+
+    std::vector<LiteralDecideNode> saved_decisions;
+    saved_decisions.swap(decision_literals);
+    long long saved_stats[3] = { decisions, propagations, conflicts };
+
+    clear_and_resize();
+    for( auto lit : root_units ){
+        literals[std::abs(lit)].value = to_bool_val(lit > 0);
+    }
     add_2_lit_watch_each_clause();
+    add_cardinality_occurs();
+    reset_decision_order();
+    memory_exhausted = false;
+    if( check_memory() ){
+        return BoolVal::NOT_ASSIGNED;
+    }
+
+    int saved_size = saved_decisions.size();
+    for( int i = 0; i < saved_size; i++ ){
+        backtrack_level += 1;
+        backtrack_data.push_back(BT());
+        decision_literals.push_back(saved_decisions[i]);
+        if( i + 1 == saved_size ) break;
+
+        if( imply_by(saved_decisions[i].lit_number, saved_decisions[i].value).type == SatRetValue::CONFLICT ){
+            return BoolVal::NOT_ASSIGNED; // not the formula of this checkpoint
+        }
+    }
+
+    // statistics of the position, the last decision is counted when it is imposed below
+    decisions = saved_stats[0];
+    propagations = saved_stats[1];
+    conflicts = saved_stats[2];
 
-    bool is_sat = DPLL_backtrack();
-    return is_sat;
+    BoolVal result = DPLL_backtrack(saved_size > 0);
+    assumptions.clear();
+    return result;
 }
 
 std::vector<BoolVal> SatSolver::answer() const {
     std::vector<BoolVal> ret;
     for(int i = 1; i <= max_var_index; i++){
-        ret.push_back(literals[i].value);
+        ret.push_back(literals[internal_var(i)].value);
     }
     return ret;
 }
 
+BoolVal SatSolver::value(int lit_num) const {
+    if( lit_num <= 0 || lit_num >= static_cast<int>(literals.size()) ){
+        return BoolVal::NOT_ASSIGNED;
+    }
+    return literals[internal_var(lit_num)].value;
+}
+
+void SatSolver::reset_decision_order(){
+    decision_order.clear();
+    decision_position.clear();
+    if( original_of_var.empty() ) return;
 
-void SatSolver::remove_unit_clause_init(){
-    std::vector<Clause> copy_clauses;
+    decision_order.assign(max_var_index + 1, 0);
+    decision_position.assign(max_var_index + 1, 0);
+    for( int position = 1; position <= max_var_index; position++ ){
+        decision_order[position] = internal_var(position);
+        decision_position[decision_order[position]] = position;
+    }
+}
+
+void SatSolver::reorder_variables(){
+    /*
+     * renumber all stored literals by locality_order(), and sort clauses by their smallest variable,
+     * so clause data is visited in about the order of literals[].
+     * reset_decision_order() keeps the decisions in original variable order, the search is
+     * the same as without renumbering, only the memory layout changes.
+     */
+    std::vector<int> order = locality_order(all_clauses, all_cardinalities, max_var_index, reorder_method);
+    original_of_var = order;
+    var_of_original.assign(max_var_index + 1, 0);
+    for( int var = 1; var <= max_var_index; var++ ){
+        var_of_original[order[var]] = var;
+    }
+
+    for( auto& clause : all_clauses ){
+        for( auto& lit : clause ) lit = internal_lit(lit);
+    }
+    for( auto& constraint : all_cardinalities ){
+        for( auto& lit : constraint.lits ) lit = internal_lit(lit);
+    }
+    for( auto& lit : assumptions ) lit = internal_lit(lit);
+    for( auto& lit : adding_clause ) lit = internal_lit(lit);
+
+    auto min_var = [](const Clause& clause){
+        int var = 0;
+        for( auto lit : clause ){
+            if( var == 0 || std::abs(lit) < var ) var = std::abs(lit);
+        }
+        return var;
+    };
+    std::stable_sort(all_clauses.begin(), all_clauses.end(),
+                     [&min_var](const Clause& a, const Clause& b){ return min_var(a) < min_var(b); });
+}
+
+
+bool SatSolver::remove_unit_clause_init(){
+    /*
+     * give value to literals of unit clauses, and simplify all clauses by these values
+     * until no new unit clause appears.
+     *
+     *   satisfied clause  => remove clause
+     *   false literal     => remove literal from clause
+     *   empty clause      => UNSAT, return false
+     *
+     * cardinality constraints are simplified in the same way:
+     *
+     *   true literal      => remove literal, bound - 1
+     *   false literal     => remove literal
+     *   bound < 0         => UNSAT, return false
+     *   bound == 0        => all literals are false (new units), remove constraint
+     *   bound >= size     => always satisfied, remove constraint
+     */
+
+    bool has_new_unit = true;
+    while( has_new_unit ){
+        has_new_unit = false;
+        std::vector<Clause> copy_clauses;
+
+        for( const Clause& this_clause : all_clauses ){
+            Clause reduced_clause;
+            bool is_sat = false;
+
+            for( auto lit : this_clause ){
+                BoolVal lit_value = literals[std::abs(lit)].value;
+                if( lit_value == BoolVal::NOT_ASSIGNED ){
+                    reduced_clause.push_back(lit);
+                }
+                else if( lit_value == to_bool_val(lit > 0) ){
+                    is_sat = true;
+                    break;
+                }
+            }
+
+            if( is_sat ) continue;
+            if( reduced_clause.empty() ) return false;
+
+            if( reduced_clause.size() == 1 ){
+                // unit clause
+                int lit = reduced_clause[0];
+                literals[std::abs(lit)].value = to_bool_val(lit > 0);
+                root_units.push_back(lit);
+                has_new_unit = true;
+                continue;
+            }
+
+            copy_clauses.push_back(reduced_clause);
+        }
+
+        all_clauses.swap(copy_clauses);
+
+        std::vector<CardinalityConstraint> copy_cardinalities;
+        for( const auto& constraint : all_cardinalities ){
+            CardinalityConstraint reduced(std::vector<int>(), constraint.bound);
+
+            for( auto lit : constraint.lits ){
+                BoolVal lit_value = literals[std::abs(lit)].value;
+                if( lit_value == BoolVal::NOT_ASSIGNED ){
+                    reduced.lits.push_back(lit);
+                }
+                else if( lit_value == to_bool_val(lit > 0) ){
+                    reduced.bound -= 1;
+                }
+            }
+
+            if( reduced.bound < 0 ) return false;
+            if( reduced.bound >= static_cast<int>(reduced.lits.size()) ) continue;
+
+            if( reduced.bound == 0 ){
+                for( auto lit : reduced.lits ){
+                    literals[std::abs(lit)].value = to_bool_val(lit < 0);
+                    root_units.push_back(-lit);
+                }
+                has_new_unit = true;
+                continue;
+            }
+
+            copy_cardinalities.push_back(reduced);
+        }
+
+        all_cardinalities.swap(copy_cardinalities);
+    }
+
+    resize_clause_data();
+    return true;
+}
+
+void SatSolver::detect_at_most_one(){
+    /*
+     * binary clause (-a -b) means at most one of a, b is true.
+     * greedily find cliques of this graph over literals, and replace each clique of
+     * size >= 3 by one at-most-one constraint, which removes size*(size-1)/2 binary clauses.
+     */
+
+    int lit_size = 2 * (max_var_index + 1);
+    vector_2d<int> neighbors(lit_size);
+    std::unordered_map<long long, int> edge_clause; // edge => binary clause index
+
+    auto edge_key = [lit_size](int lit_a, int lit_b){
+        int code_a = lit_code(lit_a), code_b = lit_code(lit_b);
+        if( code_a > code_b ) std::swap(code_a, code_b);
+        return static_cast<long long>(code_a) * lit_size + code_b;
+    };
 
     int clause_size = all_clauses.size();
-    for( int i = 0; i < clause_size; i++ ){
-        Clause& this_clause = all_clauses[i];
+    for( int clause_index = 0; clause_index < clause_size; clause_index++ ){
+        const Clause& clause = all_clauses[clause_index];
+        if( clause.size() != 2 || std::abs(clause[0]) == std::abs(clause[1]) ) continue;
 
-        if( this_clause.size() == 1 ){
-            // unit clause
-            give_literal_value_for_clause_true(i, 0);
-            // sat_clauses[i] = true; just remove clause
-            continue;
+        int lit_a = -clause[0], lit_b = -clause[1];
+        if( edge_clause.emplace(edge_key(lit_a, lit_b), clause_index).second ){
+            neighbors[lit_code(lit_a)].push_back(lit_b);
+            neighbors[lit_code(lit_b)].push_back(lit_a);
         }
-        
-        copy_clauses.push_back(this_clause);
     }
 
-    all_clauses = copy_clauses;
+    auto degree = [&neighbors](int lit){ return neighbors[lit_code(lit)].size(); };
+
+    std::vector<int> candidates;
+    for( int var = 1; var <= max_var_index; var++ ){
+        if( degree(var) >= 2 ) candidates.push_back(var);
+        if( degree(-var) >= 2 ) candidates.push_back(-var);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [&degree](int a, int b){ return degree(a) > degree(b); });
+
+    std::vector<bool> removed_clauses(clause_size, false);
+    for( auto start_lit : candidates ){
+        std::vector<int> clique(1, start_lit);
+        std::vector<int> next_lits = neighbors[lit_code(start_lit)];
+        std::sort(next_lits.begin(), next_lits.end(),
+                  [&degree](int a, int b){ return degree(a) > degree(b); });
+
+        for( auto next_lit : next_lits ){
+            bool connected = true;
+            for( auto clique_lit : clique ){
+                auto edge = edge_clause.find(edge_key(clique_lit, next_lit));
+                if( edge == edge_clause.end() || removed_clauses[edge->second] ){
+                    connected = false;
+                    break;
+                }
+            }
+            if( connected ) clique.push_back(next_lit);
+        }
+
+        if( clique.size() < 3 ) continue;
+
+        int clique_size = clique.size();
+        for( int i = 0; i < clique_size; i++ ){
+            for( int j = i + 1; j < clique_size; j++ ){
+                removed_clauses[edge_clause[edge_key(clique[i], clique[j])]] = true;
+            }
+        }
+        all_cardinalities.push_back(CardinalityConstraint(clique, 1));
+    }
+
+    std::vector<Clause> copy_clauses;
+    for( int clause_index = 0; clause_index < clause_size; clause_index++ ){
+        if( !removed_clauses[clause_index] ){
+            copy_clauses.push_back(all_clauses[clause_index]);
+        }
+    }
+    all_clauses.swap(copy_clauses);
+    resize_clause_data();
 }
 
 
+void SatSolver::add_cardinality_occurs(){
+    // occurrence list and true counter of every cardinality constraint
+    cardinality_true_count.assign(all_cardinalities.size(), 0);
+    if( all_cardinalities.empty() ){
+        vector_2d<int>().swap(cardinality_occurs); // update_cardinality() returns at once
+        return;
+    }
+    cardinality_occurs.assign(2 * (max_var_index + 1), std::vector<int>());
+
+    int constraint_size = all_cardinalities.size();
+    for( int index = 0; index < constraint_size; index++ ){
+        for( auto lit : all_cardinalities[index].lits ){
+            cardinality_occurs[lit_code(lit)].push_back(index);
+        }
+    }
+}
+
 void SatSolver::add_2_lit_watch_each_clause(){
     // 1. add 2 literal watching for every clause
     int clause_size = all_clauses.size();
@@ -68,64 +662,154 @@ void SatSolver::add_2_lit_watch_each_clause(){
     }
 }
 
-bool SatSolver::DPLL_backtrack(){
+namespace {
+
+// how much of the search loop is compiled in, from the fastest
+enum class SearchMode {
+    FAST,    // no limits, no statistics
+    COUNTED, // statistics
+    LIMITED, // statistics, conflict budget, memory limit, terminate flag and checkpoints
+    LOGGED,  // LIMITED and the search log
+};
+
+template <class Decide, class Constraints>
+BoolVal search_in_mode(SatSolver& solver, SearchMode mode, bool resume){
+    switch( mode ){
+    case SearchMode::FAST:
+        return solver.search<SearchPolicy<Decide, Constraints, NoLimits, NoStats, NoLog>>(resume);
+    case SearchMode::COUNTED:
+        return solver.search<SearchPolicy<Decide, Constraints, NoLimits, CountStats, NoLog>>(resume);
+    case SearchMode::LIMITED:
+        return solver.search<SearchPolicy<Decide, Constraints, CheckLimits, CountStats, NoLog>>(resume);
+    default:
+        return solver.search<SearchPolicy<Decide, Constraints, CheckLimits, CountStats, StderrLog>>(resume);
+    }
+}
+
+}
+
+BoolVal SatSolver::DPLL_backtrack(bool resume){
+    /*
+     * runtime dispatcher: the configuration is fixed during a search, so pick the search()
+     * specialised for it once, features which are not used cost nothing per propagation.
+     */
+    SearchMode mode = SearchMode::FAST;
+    if( search_log ){
+        mode = SearchMode::LOGGED;
+    }
+    else if( conflict_budget >= 0 || terminate_flag || checkpoint_request || memory_limit > 0 ){
+        mode = SearchMode::LIMITED;
+    }
+    else if( count_stats ){
+        mode = SearchMode::COUNTED;
+    }
+
+    bool list_order = !decision_order.empty();
+    bool cardinality = !all_cardinalities.empty();
+    if( list_order && cardinality ) return search_in_mode<ListOrder, WithCardinality>(*this, mode, resume);
+    if( list_order )                return search_in_mode<ListOrder, ClausesOnly>(*this, mode, resume);
+    if( cardinality )               return search_in_mode<VariableOrder, WithCardinality>(*this, mode, resume);
+    return search_in_mode<VariableOrder, ClausesOnly>(*this, mode, resume);
+}
+
+template <class Policy>
+BoolVal SatSolver::search(bool resume){
     // backtracking for each clause
+    //   assumptions are decided first with bt_state 1, so they are never inverted.
+    //   return TRUE: SAT, FALSE: UNSAT, NOT_ASSIGNED: stopped by budget or terminate flag
 
     bool find_next = true;
     int lit_counter = 0;
+    int assumption_counter = 0;
+    int assumption_size = assumptions.size();
+
+    if( resume ){
+        // block_model() inverted the last decision, imply it as after a conflict
+        lit_counter = Policy::Decide::position(*this, decision_literals.back().lit_number);
+        assumption_counter = assumption_size;
+        find_next = false;
+    }
 
     while( 1 ){
         // backtracking by loop
 
-        if( find_next ){
+        // decision_literals are the search position here: all but the last are implied,
+        // imply of the last is (re)done below, so a checkpoint can be taken before stopping
+        if( Policy::Limits::stopped(*this) ){
+            return BoolVal::NOT_ASSIGNED;
+        }
+
+        if( find_next && assumption_counter < assumption_size ){
+            int lit = assumptions[assumption_counter++];
+            BoolVal lit_value = literals[std::abs(lit)].value;
+
+            if( lit_value == to_bool_val(lit > 0) ){
+                continue;
+            }
+            if( lit_value != BoolVal::NOT_ASSIGNED ){
+                // assumption is false by previous assumptions
+                return BoolVal::FALSE;
+            }
+
+            backtrack_level += 1;
+            backtrack_data.push_back(BT());
+            decision_literals.emplace_back(std::abs(lit), lit > 0, 1);
+        }
+        else if( find_next ){
             lit_counter = search_next_lit(lit_counter);
 
             if( lit_counter > max_var_index ){
                 break;
             }
 
-            if( literals[lit_counter].value != BoolVal::NOT_ASSIGNED ){
+            int var = Policy::Decide::var(*this, lit_counter);
+            if( literals[var].value != BoolVal::NOT_ASSIGNED ){
                 continue;
             }
             
             // only init decision_literal and bt level
             backtrack_level += 1;
             backtrack_data.push_back(BT());
-            decision_literals.emplace_back(lit_counter, true, 0);
+            decision_literals.emplace_back(var, true, 0);
         }
 
-#ifdef DEBUG2
-    std::cerr << "[decide] x" << decision_literals.back().lit_number 
-              << " = " << decision_literals.back().value << std::endl;
-#endif
-        SatRetValue ret = imply_by(decision_literals.back().lit_number, decision_literals.back().value);
+        Policy::Log::decide(decision_literals.back().lit_number, decision_literals.back().value);
+        Policy::Stats::decision(*this);
+        SatRetValue ret = imply_by<Policy>(decision_literals.back().lit_number, decision_literals.back().value);
 
         if( ret.type == SatRetValue::NORMAL ){
             find_next = true;
             continue;
         }
         else if( ret.type == SatRetValue::CONFLICT ){
+            Policy::Log::conflict(ret.conflict_lit);
+            Policy::Stats::conflict(*this);
+            if( Policy::Limits::over_budget(*this) ){
+                return BoolVal::NOT_ASSIGNED;
+            }
 
-#ifdef DEBUG2
-    std::cerr << "[conflict] " << ret.conflict_lit << std::endl;
-#endif
             bool has_next = backtrack_next();
 
             if( !has_next ){
                 // UNSAT
-                return false;
+                return BoolVal::FALSE;
             }
 
-            lit_counter = decision_literals.back().lit_number;
+            lit_counter = Policy::Decide::position(*this, decision_literals.back().lit_number);
             find_next = false;
             continue;
         }
     }
 
-    return true;
+    return BoolVal::TRUE;
 }
 
 /* based on 2-literal watching */
+SatRetValue SatSolver::imply_by(int lit_num, bool set_value){
+    return imply_by<GenericPolicy>(lit_num, set_value);
+}
+
+template <class Policy>
 SatRetValue SatSolver::imply_by(int lit_num, bool set_value){
     /*
      * make implication when the literal is set;
@@ -144,7 +828,15 @@ SatRetValue SatSolver::imply_by(int lit_num, bool set_value){
      *   4. Conflict
      */
     
-    bt_set_literal_value(lit_num, set_value);
+    Policy::Stats::propagation(*this);
+    bt_assign_literal(lit_num, set_value);
+
+    if( Policy::Constraints::cardinality ){
+        SatRetValue card_ret = update_cardinality(lit_num, set_value);
+        if( card_ret.type == SatRetValue::CONFLICT ){
+            return card_ret;
+        }
+    }
 
     // do implication
     if( set_value == true ){
@@ -182,23 +874,72 @@ SatRetValue SatSolver::imply_by(int lit_num, bool set_value){
             }
         }
 
-        return imply_by(lit);
+        return imply_by<Policy>(lit);
+    }
+
+    while( Policy::Constraints::cardinality && !cardinality_implied_queue.empty() ){
+        int lit = cardinality_implied_queue.front();
+        cardinality_implied_queue.pop_front();
+
+        BoolVal lit_value = literals[std::abs(lit)].value;
+        if( lit_value == to_bool_val(lit > 0) ){
+            continue;
+        }
+        else if( lit_value != BoolVal::NOT_ASSIGNED ){
+            return SatRetValue(SatRetValue::CONFLICT);
+        }
+
+        return imply_by<Policy>(std::abs(lit), lit > 0);
     }
 
     return SatRetValue(SatRetValue::NORMAL);
 }
 
+SatRetValue SatSolver::update_cardinality(int lit_num, bool set_value){
+    /*
+     * count the literal which becomes true in its cardinality constraints.
+     *
+     *   count > bound  => conflict
+     *   count == bound => other not assigned literals must be false
+     *
+     * all counters are updated even on conflict, remove_last_backtrack_data() undoes them.
+     */
+    if( cardinality_occurs.empty() ){
+        return SatRetValue(SatRetValue::NORMAL);
+    }
+
+    int true_lit = set_value ? lit_num : -lit_num;
+    SatRetValue ret(SatRetValue::NORMAL);
+
+    for( auto index : cardinality_occurs[lit_code(true_lit)] ){
+        const CardinalityConstraint& constraint = all_cardinalities[index];
+        int count = ++cardinality_true_count[index];
+
+        if( count > constraint.bound ){
+            ret = SatRetValue(SatRetValue::CONFLICT);
+        }
+        else if( count == constraint.bound ){
+            for( auto lit : constraint.lits ){
+                if( literals[std::abs(lit)].value == BoolVal::NOT_ASSIGNED ){
+                    cardinality_implied_queue.push_back(-lit);
+                }
+            }
+        }
+    }
+    return ret;
+}
+
+template <class Policy>
 SatRetValue SatSolver::imply_by(LiteralIndex lit_index){
     int number = all_clauses[lit_index.clause_index][lit_index.lit_index_in_clause];
+    Policy::Log::imply(lit_index, number);
 
-#ifdef DEBUG2
-    std::cerr << "[imply] " << lit_index 
-              << " = " << (number > 0) << std::endl;
-#endif
-
-    return imply_by(std::abs(number), number > 0);
+    return imply_by<Policy>(std::abs(number), number > 0);
 }
 
+// the propagation of the FAST search, for micro_bench.cpp
+template SatRetValue SatSolver::imply_by<FastPolicy>(int lit_num, bool set_value);
+
 void SatSolver::set_watched_literals_true(std::vector<LiteralIndex>& watched_lits){
     /* set the value of all watched literal to true */
 
@@ -216,7 +957,7 @@ SatRetValue SatSolver::set_watched_literals_false(std::vector<LiteralIndex>& wat
     int size = watched_lits.size();
     for( int i = 0; i < size; i++ ){
         // each watched literal's clause
-        LiteralIndex& false_lit = watched_lits[i];
+        LiteralIndex false_lit = watched_lits[i]; // copy, updating may erase it from watched_lits
         SatRetValue ret = update_literal_row(false_lit);
 
         // HACK: fix size and i when watched_lits array elements are removed in literal updating.
@@ -338,12 +1079,195 @@ void SatSolver::clear_and_resize(){
     literals.clear();
     sat_clauses.clear();
     clause_watched_2_lit.clear();
+    cardinality_occurs.clear();
+    cardinality_true_count.clear();
     backtrack_init();
 
-    int clause_size = all_clauses.size();
     literals.resize(max_var_index + 1);
-    sat_clauses.resize(clause_size, false);
-    clause_watched_2_lit.resize(clause_size);
+    resize_clause_data();
+}
+
+namespace {
+
+// malloc header and alignment of a heap block, an estimate
+const std::size_t heap_block_overhead = 2 * sizeof(void*);
+
+template <class T>
+std::size_t heap_bytes(const std::vector<T>& data){
+    return data.capacity() == 0 ? 0 : data.capacity() * sizeof(T) + heap_block_overhead;
+}
+
+std::size_t heap_bytes(const std::vector<bool>& data){
+    return data.capacity() == 0 ? 0 : data.capacity() / 8 + heap_block_overhead;
+}
+
+template <class T>
+std::size_t heap_bytes(const std::deque<T>& data){
+    // 512 byte blocks and the block map
+    const std::size_t block_size = 512;
+    std::size_t blocks = data.size() * sizeof(T) / block_size + 1;
+    return blocks * (block_size + heap_block_overhead) + 8 * sizeof(void*) + heap_block_overhead;
+}
+
+template <class T>
+std::size_t heap_bytes(const vector_2d<T>& data){
+    std::size_t bytes = heap_bytes<std::vector<T>>(data);
+    for( const auto& row : data ) bytes += heap_bytes(row);
+    return bytes;
+}
+
+}
+
+std::size_t memory_bytes(const std::vector<Clause>& clauses){
+    return heap_bytes(clauses);
+}
+
+std::size_t memory_bytes(const std::vector<CardinalityConstraint>& constraints){
+    std::size_t bytes = heap_bytes(constraints);
+    for( const auto& constraint : constraints ) bytes += heap_bytes(constraint.lits);
+    return bytes;
+}
+
+MemoryUsage setup_memory_estimate(const std::vector<Clause>& clauses,
+                                  const std::vector<CardinalityConstraint>& constraints, int max_var_index){
+    /*
+     * two peaks, the larger one is returned:
+     *   simplification: remove_unit_clause_init() builds the simplified clauses next to the old ones
+     *   watches:        every clause gets 2 watches, lists grown by push_back() hold up to 2x
+     */
+    std::size_t vars = max_var_index + 1;
+    std::size_t clause_size = clauses.size();
+    std::size_t arrays = vars * sizeof(WatchedLiteral) + clause_size * sizeof(LiteralIndexPair) +
+                         clause_size / 8 + 3 * heap_block_overhead;
+
+    MemoryUsage simplification;
+    simplification.estimated = true;
+    simplification.clauses = 2 * memory_bytes(clauses);
+    simplification.watches = arrays;
+
+    MemoryUsage watches;
+    watches.estimated = true;
+    watches.clauses = memory_bytes(clauses);
+    watches.watches = arrays + 2 * clause_size * 2 * sizeof(LiteralIndex) +
+                      std::min(2 * vars, 2 * clause_size) * heap_block_overhead;
+
+    if( !constraints.empty() ){
+        std::size_t lit_size = 0;
+        for( const auto& constraint : constraints ) lit_size += constraint.lits.size();
+        simplification.cardinality = 2 * memory_bytes(constraints);
+        watches.cardinality = memory_bytes(constraints) + 2 * lit_size * sizeof(int) +
+                              2 * vars * sizeof(std::vector<int>) + constraints.size() * sizeof(int) +
+                              std::min(2 * vars, lit_size) * heap_block_overhead;
+    }
+    return simplification.total() > watches.total() ? simplification : watches;
+}
+
+bool SatSolver::check_memory_estimate(const MemoryUsage& estimate){
+    if( memory_limit == 0 || estimate.total() <= memory_limit ){
+        return false;
+    }
+    memory_exhausted = true;
+    memory_at_limit = estimate;
+    return true;
+}
+
+MemoryUsage SatSolver::memory_usage() const {
+    /* walks clauses and literals, about as costly as setting up the watches once */
+    MemoryUsage usage;
+    usage.clauses = heap_bytes(all_clauses) + heap_bytes(adding_clause) + heap_bytes(root_units) + heap_bytes(assumptions);
+
+    usage.watches = heap_bytes(literals) + heap_bytes(clause_watched_2_lit) + heap_bytes(sat_clauses);
+    for( const auto& literal : literals ){
+        usage.watches += heap_bytes(literal.pos_watched) + heap_bytes(literal.neg_watched);
+    }
+
+    usage.cardinality = memory_bytes(all_cardinalities) + heap_bytes(cardinality_occurs) +
+                        heap_bytes(cardinality_true_count);
+
+    usage.undo = heap_bytes(backtrack_data) + heap_bytes(decision_literals) +
+                 heap_bytes(unit_clause_queue) + heap_bytes(cardinality_implied_queue);
+    for( const auto& bt : backtrack_data ){
+        usage.undo += heap_bytes(bt.updated_literals) + heap_bytes(bt.updated_sat_clauses);
+    }
+
+    usage.other = heap_bytes(projection_vars) + heap_bytes(is_projected) + heap_bytes(shrink_required) +
+                  heap_bytes(decision_order) + heap_bytes(decision_position) +
+                  heap_bytes(original_of_var) + heap_bytes(var_of_original) + engine_bytes;
+    return usage;
+}
+
+void SatSolver::compact(){
+    /*
+     * release unused capacity, contents and indices stay the same, so it is done between
+     * conflicts or models of a running search. Vectors grown by push_back() hold up to 2x their size.
+     */
+    TRACE_SCOPE("compact");
+    // a CheckpointWriter thread reads all_clauses while the search runs, see checkpoint.h
+    if( checkpoint_request == nullptr ){
+        for( auto& clause : all_clauses ){
+            clause.shrink_to_fit();
+        }
+        all_clauses.shrink_to_fit();
+    }
+    for( auto& literal : literals ){
+        literal.pos_watched.shrink_to_fit();
+        literal.neg_watched.shrink_to_fit();
+    }
+    for( auto& occurs : cardinality_occurs ){
+        occurs.shrink_to_fit();
+    }
+    for( auto& bt : backtrack_data ){
+        bt.updated_literals.shrink_to_fit();
+        bt.updated_sat_clauses.shrink_to_fit();
+    }
+    backtrack_data.shrink_to_fit();
+    decision_literals.shrink_to_fit();
+    unit_clause_queue.shrink_to_fit();
+    cardinality_implied_queue.shrink_to_fit();
+    compactions += 1;
+}
+
+bool SatSolver::memory_over_limit(){
+    if( memory_limit == 0 || --memory_check_countdown > 0 ){
+        return false;
+    }
+    memory_check_countdown = memory_check_interval;
+    return check_memory();
+}
+
+bool SatSolver::check_memory(){
+    /*
+     * graceful degradation:
+     *   above 3/4 of the limit: compact(), again when usage has grown by 1/16 of the limit
+     *   above the limit:        compact() once more, still above => memory_exhausted
+     */
+    if( memory_limit == 0 ){
+        return false;
+    }
+
+    MemoryUsage usage = memory_usage();
+    if( usage.total() > memory_limit / 4 * 3 &&
+        (compactions == 0 || usage.total() > compacted_usage + memory_limit / 16) ){
+        compact();
+        usage = memory_usage();
+        compacted_usage = usage.total();
+    }
+    if( usage.total() > memory_limit && usage.total() != compacted_usage ){
+        compact();
+        usage = memory_usage();
+        compacted_usage = usage.total();
+    }
+    memory_exhausted = usage.total() > memory_limit;
+    if( memory_exhausted ){
+        memory_at_limit = usage;
+    }
+    return memory_exhausted;
+}
+
+void SatSolver::resize_clause_data(){
+    int clause_size = all_clauses.size();
+    sat_clauses.assign(clause_size, false);
+    clause_watched_2_lit.assign(clause_size, LiteralIndexPair());
 }
 
 BoolVal SatSolver::literal_truth_in_clause(int clause_index, int lit_index_in_clause){
@@ -420,11 +1344,58 @@ void SatSolver::give_literal_value_for_clause_true(int clause_index, int lit_ind
     }
 }
 
+// ModelCount
+void ModelCount::add_power_of_two(int k){
+    std::size_t index = k / 32;
+    if( limbs.size() <= index ) limbs.resize(index + 1, 0);
+
+    uint64_t carry = uint64_t(1) << (k % 32);
+    for( std::size_t i = index; carry != 0; i++ ){
+        if( i == limbs.size() ) limbs.push_back(0);
+        uint64_t sum = limbs[i] + carry;
+        limbs[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+}
+
+std::string ModelCount::str() const {
+    // repeated division by 10^9
+    std::vector<uint32_t> rest(limbs);
+    std::vector<uint32_t> chunks;
+    while( !rest.empty() ){
+        uint64_t remainder = 0;
+        for( std::size_t i = rest.size(); i-- > 0; ){
+            uint64_t current = (remainder << 32) | rest[i];
+            rest[i] = static_cast<uint32_t>(current / 1000000000);
+            remainder = current % 1000000000;
+        }
+        chunks.push_back(static_cast<uint32_t>(remainder));
+        while( !rest.empty() && rest.back() == 0 ) rest.pop_back();
+    }
+    if( chunks.empty() ) return "0";
+
+    std::string text = std::to_string(chunks.back());
+    for( std::size_t i = chunks.size() - 1; i-- > 0; ){
+        std::string digits = std::to_string(chunks[i]);
+        text += std::string(9 - digits.size(), '0') + digits;
+    }
+    return text;
+}
+
+double ModelCount::approx() const {
+    double value = 0;
+    for( std::size_t i = limbs.size(); i-- > 0; ){
+        value = value * 4294967296.0 + limbs[i];
+    }
+    return value;
+}
+
 // backtrack
 void SatSolver::backtrack_init(){
     backtrack_level = 0;
     decision_literals.clear();
     unit_clause_queue.clear();
+    cardinality_implied_queue.clear();
     backtrack_data.clear();
 }
 
@@ -436,6 +1407,7 @@ bool SatSolver::backtrack_next(){
     if( last_decision_lit.bt_state == 0 ){
         remove_last_backtrack_data();
         unit_clause_queue.clear();
+        cardinality_implied_queue.clear();
 
         // only init decision_literal, bt level, and empty backtrack_data
         last_decision_lit.bt_state = 1;
@@ -457,6 +1429,7 @@ void SatSolver::backtrack_pop(){
         
     remove_last_backtrack_data();
     unit_clause_queue.clear();
+    cardinality_implied_queue.clear();
     decision_literals.pop_back();
     backtrack_level -= 1;
 }
@@ -466,6 +1439,12 @@ void SatSolver::remove_last_backtrack_data(){
         
     BT& last_layer = backtrack_data[backtrack_level - 1];
     for( auto lit_num : last_layer.updated_literals ){
+        if( !cardinality_occurs.empty() ){
+            int true_lit = literals[lit_num].value == BoolVal::TRUE ? lit_num : -lit_num;
+            for( auto index : cardinality_occurs[lit_code(true_lit)] ){
+                cardinality_true_count[index] -= 1;
+            }
+        }
         literals[lit_num].value = BoolVal::NOT_ASSIGNED;
     }
     for( auto clause_index : last_layer.updated_sat_clauses ){
@@ -480,16 +1459,11 @@ void SatSolver::bt_set_clause_sat(int clause_index){
     backtrack_data[backtrack_level - 1].updated_sat_clauses.push_back(clause_index);
 }
 
-void SatSolver::bt_set_literal_value(int lit_num, bool value){
+void SatSolver::bt_assign_literal(int lit_num, bool value){
     literals[lit_num].value = to_bool_val(value);
     backtrack_data[backtrack_level - 1].updated_literals.push_back(lit_num);
 }
 
-void SatSolver::bt_set_literal_value(int lit_num, BoolVal value){
-    literals[lit_num].value = value;
-    backtrack_data[backtrack_level - 1].updated_literals.push_back(lit_num);
-}
-
 // debug use
     
 void SatSolver::print_clause_watched_2_lit(){
@@ -5,6 +5,15 @@
 #include <array>
 #include <deque>
 #include <ostream>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "utils.h"
+#include "reorder.h"
 
 // 2 literal watching
 
@@ -31,6 +40,7 @@ enum class BoolVal {
 };
 
 std::ostream& operator << (std::ostream& os, const BoolVal& value);
+void print_sat_solution(std::ostream& output_stream, const std::vector<BoolVal>& answer);
 
 static BoolVal to_bool_val(bool value){
     if( value == true ) return BoolVal::TRUE;
@@ -58,6 +68,7 @@ struct LiteralIndex {
 static std::ostream& operator << (std::ostream& os, const LiteralIndex& value){
     os << "Lit: x" << value.lit_number << " at ";
     os << "(" << value.clause_index << ", " << value.lit_index_in_clause << ")";
+    return os;
 }
 
 using LiteralIndexPair = std::array<LiteralIndex, 2>;
@@ -95,8 +106,57 @@ struct SatRetValue {
         type(type), conflict_lit(conflict_lit) {}
 };
 
+// ModelCount: unbounded model count, sum of 2^k for enumerated cubes
+class ModelCount {
+public:
+    void add_power_of_two(int k);
+    std::string str() const; // decimal
+    double approx() const;
+
+private:
+    std::vector<uint32_t> limbs; // base 2^32, least significant first
+};
+
+// MemoryUsage: bytes of solver structures, by capacity, with an estimate of allocator overhead
+struct MemoryUsage {
+    std::size_t clauses;     // all_clauses, clause being added, root units, assumptions
+    std::size_t watches;     // watch lists of literals[], clause_watched_2_lit, sat_clauses
+    std::size_t cardinality; // cardinality constraints, occurrence lists and counters
+    std::size_t undo;        // BT undo logs, decision stack, implication queues
+    std::size_t other;       // enumeration, renumbering and lookahead engine data
+
+    bool estimated;          // setup_memory_estimate(), not measured
+
+    MemoryUsage() : clauses(0), watches(0), cardinality(0), undo(0), other(0), estimated(false) {}
+    std::size_t total() const { return clauses + watches + cardinality + undo + other; }
+};
+
+// SearchEngine: DPLL (search<Policy>(), see search_policy.h) or LOOKAHEAD (see lookahead.h)
+enum class SearchEngine { DPLL, LOOKAHEAD };
+
+struct LookaheadStats {
+    long long lookaheads;
+    long long failed_literals;
+    long long double_lookaheads;
+    long long learned_implications; // local learning of double lookaheads
+
+    LookaheadStats() : lookaheads(0), failed_literals(0), double_lookaheads(0), learned_implications(0) {}
+};
+
+std::size_t memory_bytes(const std::vector<Clause>& clauses);
+std::size_t memory_bytes(const std::vector<CardinalityConstraint>& constraints);
+// peak of solve_limited() before its search (simplification copy, watches), from the size of the input
+MemoryUsage setup_memory_estimate(const std::vector<Clause>& clauses,
+                                  const std::vector<CardinalityConstraint>& constraints, int max_var_index);
+
 class SatSolver {
 public:
+    SatSolver() : max_var_index(0), detect_amo(false), reorder_method(ReorderMethod::NONE),
+                  engine(SearchEngine::DPLL), engine_bytes(0),
+                  conflict_budget(-1), terminate_flag(nullptr),
+                  checkpoint_request(nullptr), memory_limit(0), memory_check_countdown(memory_check_interval),
+                  compacted_usage(0), compactions(0), memory_exhausted(false), count_stats(true), search_log(false),
+                  decisions(0), propagations(0), conflicts(0), backtrack_level(0) {}
 
     // debug use
     
@@ -106,26 +166,83 @@ public:
     // APIs
 
     void set_clauses(const std::vector<Clause>& clauses, int max_var_index);
+    void add_lit(int lit);  // stream clauses in, 0 terminates the clause
+    void assume(int lit);   // assumption literal for next solve() only
+    void add_at_most(const std::vector<int>& lits, int bound);  // at most `bound' of lits are true
+    void add_at_least(const std::vector<int>& lits, int bound); // at least `bound' of lits are true
+    void set_detect_at_most_one(bool enable) { detect_amo = enable; }
+    // renumber variables for locality before the first search, see reorder.h.
+    // the API keeps using the original variable ids.
+    void set_reorder(ReorderMethod method) { reorder_method = method; }
+    // solve_limited() only, enumerate() and resume_limited() always use DPLL
+    void set_engine(SearchEngine search_engine) { engine = search_engine; }
     bool solve();
+    BoolVal solve_limited(); // TRUE: SAT, FALSE: UNSAT, NOT_ASSIGNED: budget exhausted or terminated
+    void set_conflict_budget(long long budget) { conflict_budget = budget; } // < 0: no limit
+    void set_terminate_flag(const std::atomic<bool>* flag) { terminate_flag = flag; }
+    // hook(*this) is called by the search loop when *request is set, see checkpoint.h
+    void set_checkpoint_hook(std::atomic<bool>* request, std::function<void(const SatSolver&)> hook){
+        checkpoint_request = request;
+        checkpoint_hook = hook;
+    }
+    // statistics are always counted when a limit or checkpoint needs them
+    void set_statistics(bool enable) { count_stats = enable; }
+    void set_search_log(bool enable) { search_log = enable; } // decisions, implications, conflicts on stderr
+    // bounded memory: near `bytes' the solver compacts its structures, above it the search
+    // stops with NOT_ASSIGNED and memory_exhausted is set. 0: no limit
+    void set_memory_limit(std::size_t bytes) { memory_limit = bytes; }
+    MemoryUsage memory_usage() const;
+    bool check_memory_estimate(const MemoryUsage& estimate); // above the limit => memory_exhausted
+    BoolVal resume_limited(); // continue the search position loaded by load_checkpoint()
     std::vector<BoolVal> answer() const;
-
-    void remove_unit_clause_init();
+    BoolVal value(int lit_num) const; // model access without copy
+    int num_vars() const { return max_var_index; }
+
+    // all models: each model is shrunk to a partial assignment (cube) over `projection'
+    // (all variables if empty) and given to on_model() as soon as it is found,
+    // a cube of k literals stands for 2^(projection size - k) models. on_model() returns false to stop.
+    // projected variables beyond num_vars() are added as free variables.
+    //   return FALSE: all models are enumerated, NOT_ASSIGNED: stopped by budget, terminate flag or on_model()
+    BoolVal enumerate(const std::vector<int>& projection,
+                      const std::function<bool(const std::vector<int>&)>& on_model);
+
+    bool remove_unit_clause_init();
     void add_2_lit_watch_each_clause();
-
-    bool DPLL_backtrack();
-    SatRetValue imply_by(LiteralIndex lit_index);
-    SatRetValue imply_by(int lit_num, bool set_value);
+    void detect_at_most_one();
+    void add_cardinality_occurs();
+
+    // DPLL_backtrack() picks the search<Policy>() specialised for the configuration, see search_policy.h
+    BoolVal DPLL_backtrack(bool resume = false); // resume: continue after block_model()
+    template <class Policy> BoolVal search(bool resume);
+    template <class Policy> SatRetValue imply_by(LiteralIndex lit_index);
+    template <class Policy> SatRetValue imply_by(int lit_num, bool set_value);
+    SatRetValue imply_by(int lit_num, bool set_value); // GenericPolicy, outside of a search
+    BoolVal lookahead_search(); // lookahead.cpp
     // conflict();
     void set_watched_literals_true(std::vector<LiteralIndex>& watched_lits);
     SatRetValue set_watched_literals_false(std::vector<LiteralIndex>& watched_lits);
     SatRetValue update_literal_row(LiteralIndex literal);
     SatRetValue update_literal(int clause_index, int clause_2_lit_offset);
+    SatRetValue update_cardinality(int lit_num, bool set_value);
 
     // helper functions of internal data
     
     int search_next_lit(int lit_counter);
+    void reset_decision_order(); // decide in the order of original variable ids
+    void reorder_variables();
+    int internal_var(int var) const { return var < static_cast<int>(var_of_original.size()) ? var_of_original[var] : var; }
+    int original_var(int var) const { return var < static_cast<int>(original_of_var.size()) ? original_of_var[var] : var; }
+    int internal_lit(int lit) const { return lit < 0 ? -internal_var(-lit) : internal_var(lit); }
+    int original_lit(int lit) const { return lit < 0 ? -original_var(-lit) : original_var(lit); }
+    void shrink_model(std::vector<int>& cube);
+    bool block_model(const std::vector<int>& cube);
     // add_new_clause();
     void clear_and_resize();
+    void compact();             // release unused capacity of clause, watch and undo data
+    bool memory_over_limit();   // check_memory() every memory_check_interval calls
+    bool check_memory();        // compact near the limit, true above it
+    void resize_clause_data();
+    static int lit_code(int lit) { return 2 * std::abs(lit) + (lit < 0); } // index of literal
 
     BoolVal literal_truth_in_clause(int clause_index, int lit_index_in_clause);
     BoolVal literal_truth_in_clause(LiteralIndex lit_index);
@@ -141,21 +258,68 @@ public:
     void remove_last_backtrack_data();
 
     void bt_set_clause_sat(int clause_index);
-    void bt_set_literal_value(int lit_num, bool value);
-    void bt_set_literal_value(int lit_num, BoolVal value);
+    void bt_assign_literal(int lit_num, bool value); // set and log for undo, Stats policies count it
 
     // clauses map
     int max_var_index;
     std::vector<Clause> all_clauses;
+    Clause adding_clause;          // clause being streamed by add_lit()
+    std::vector<int> root_units;   // literals fixed by remove_unit_clause_init()
+    std::vector<int> assumptions;
+    std::vector<CardinalityConstraint> all_cardinalities;
+    bool detect_amo;               // replace pairwise at-most-one groups of binary clauses
+
+    // variable renumbering, empty: not renumbered, variables out of range keep their id
+    ReorderMethod reorder_method;
+    std::vector<int> original_of_var;  // internal variable => original variable
+    std::vector<int> var_of_original;  // original variable => internal variable
+
+    SearchEngine engine;
+    std::size_t engine_bytes;     // data of the lookahead engine during its search
+
+    // limits
+    long long conflict_budget;
+    const std::atomic<bool>* terminate_flag;
+    std::atomic<bool>* checkpoint_request;
+    std::function<void(const SatSolver&)> checkpoint_hook;
+
+    // memory limit, checked after conflicts and enumerated models
+    static const int memory_check_interval = 1024;
+    std::size_t memory_limit;
+    int memory_check_countdown;
+    std::size_t compacted_usage;  // usage after the last compact()
+    long long compactions;
+    bool memory_exhausted;        // last search was stopped by memory_limit
+    MemoryUsage memory_at_limit;  // usage when it stopped, before enumerate() drops blocking clauses
+
+    // statistics
+    bool count_stats;
+    bool search_log;
+    long long decisions;
+    long long propagations; // assigned literals, include decisions
+    long long conflicts;
+    LookaheadStats lookahead_stats;
 
     // internal data
     std::vector<WatchedLiteral> literals; // literal use 1-based array
     std::vector<bool> sat_clauses;        // clause  use 0-based array
     std::vector<LiteralIndexPair> clause_watched_2_lit;
 
+    // cardinality constraints, counter based
+    vector_2d<int> cardinality_occurs;       // lit_code(lit) => constraints which contain lit
+    std::vector<int> cardinality_true_count; // number of true literals in constraint
+
+    // enumeration
+    std::vector<int> projection_vars;
+    std::vector<bool> is_projected;
+    std::vector<bool> shrink_required;
+    std::vector<int> decision_order;    // position => variable, 1-based, empty: variable order
+    std::vector<int> decision_position; // variable => position
+
     // backtrack
     int backtrack_level;
     std::deque<LiteralIndex> unit_clause_queue; // push the unique not_assigned literal into the queue.
+    std::deque<int> cardinality_implied_queue;  // literals which must be true by cardinality constraints
     std::vector<LiteralDecideNode> decision_literals;
 
     struct BT {
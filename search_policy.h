@@ -0,0 +1,102 @@
+#ifndef __SEARCH_POLICY_H__
+#define __SEARCH_POLICY_H__
+
+#include <atomic>
+#include <iostream>
+
+#include "sat_solver.h"
+
+// policies of SatSolver::search<Policy>() and SatSolver::imply_by<Policy>()
+//
+// each policy is a set of static functions (or constants) of one feature, a disabled feature
+// is an empty function and is compiled out of the search loop and propagation.
+// SatSolver::DPLL_backtrack() picks one specialised search per solve:
+//
+//   Decide:      VariableOrder (position is the variable) | ListOrder (decision_order[])
+//   Constraints: ClausesOnly | WithCardinality (counter based cardinality constraints)
+//   Limits:      NoLimits | CheckLimits (conflict budget, memory limit, terminate flag, checkpoint hook)
+//   Stats:       NoStats | CountStats (decisions, propagations, conflicts)
+//   Log:         NoLog | StderrLog (decisions, implications and conflicts on stderr)
+
+struct VariableOrder {
+    static int var(const SatSolver&, int position) { return position; }
+    static int position(const SatSolver&, int var) { return var; }
+};
+
+struct ListOrder {
+    static int var(const SatSolver& solver, int position) { return solver.decision_order[position]; }
+    static int position(const SatSolver& solver, int var) { return solver.decision_position[var]; }
+};
+
+struct ClausesOnly {
+    static const bool cardinality = false;
+};
+
+struct WithCardinality {
+    static const bool cardinality = true;
+};
+
+struct NoLimits {
+    static bool stopped(SatSolver&) { return false; }
+    static bool over_budget(SatSolver&) { return false; }
+};
+
+struct CheckLimits {
+    // decision_literals are the search position when it is called, see checkpoint.h
+    static bool stopped(SatSolver& solver){
+        if( solver.checkpoint_request && solver.checkpoint_request->load(std::memory_order_relaxed) ){
+            solver.checkpoint_hook(solver);
+        }
+        return solver.terminate_flag && solver.terminate_flag->load(std::memory_order_relaxed);
+    }
+    static bool over_budget(SatSolver& solver){
+        return (solver.conflict_budget >= 0 && solver.conflicts > solver.conflict_budget) || solver.memory_over_limit();
+    }
+};
+
+struct NoStats {
+    static void decision(SatSolver&) {}
+    static void propagation(SatSolver&) {}
+    static void conflict(SatSolver&) {}
+};
+
+struct CountStats {
+    static void decision(SatSolver& solver) { solver.decisions += 1; }
+    static void propagation(SatSolver& solver) { solver.propagations += 1; }
+    static void conflict(SatSolver& solver) { solver.conflicts += 1; }
+};
+
+struct NoLog {
+    static void decide(int, bool) {}
+    static void imply(const LiteralIndex&, int) {}
+    static void conflict(const LiteralIndex&) {}
+};
+
+struct StderrLog {
+    static void decide(int var, bool value){
+        std::cerr << "[decide] x" << var << " = " << value << std::endl;
+    }
+    static void imply(const LiteralIndex& lit_index, int number){
+        std::cerr << "[imply] " << lit_index << " = " << (number > 0) << std::endl;
+    }
+    static void conflict(const LiteralIndex& lit_index){
+        std::cerr << "[conflict] " << lit_index << std::endl;
+    }
+};
+
+template <class DecideT, class ConstraintsT, class LimitsT, class StatsT, class LogT>
+struct SearchPolicy {
+    using Decide = DecideT;
+    using Constraints = ConstraintsT;
+    using Limits = LimitsT;
+    using Stats = StatsT;
+    using Log = LogT;
+};
+
+// imply_by() outside of a search: every feature, checked at run time
+using GenericPolicy = SearchPolicy<VariableOrder, WithCardinality, CheckLimits, CountStats, NoLog>;
+
+// the FAST search of DPLL_backtrack() on clauses only, imply_by<FastPolicy>() is instantiated for micro_bench.cpp
+using FastPolicy = SearchPolicy<VariableOrder, ClausesOnly, NoLimits, NoStats, NoLog>;
+
+#endif /* end of include guard: __SEARCH_POLICY_H__ */
@@ -0,0 +1,429 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "server.h"
+#include "sat_solver.h"
+#include "trace.h"
+
+static std::atomic<bool> server_stop(false);
+static std::atomic<int> session_count(0);
+
+// largest variable of a session, lit_code() of its literals fits in int
+static const long max_session_var = (1L << 30) - 1;
+
+static void stop_server(int){
+    server_stop = true;
+}
+
+// WorkerPool: fixed number of threads running solve jobs
+class WorkerPool {
+public:
+    explicit WorkerPool(int worker_count) : stopped(false) {
+        for( int i = 0; i < worker_count; i++ ){
+            workers.emplace_back(&WorkerPool::work, this);
+        }
+    }
+
+    ~WorkerPool(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        job_ready.notify_all();
+        for( auto& worker : workers ){
+            worker.join();
+        }
+    }
+
+    void submit(std::function<void()> job){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(job);
+        }
+        job_ready.notify_one();
+    }
+
+private:
+    void work(){
+        trace_thread_name("worker");
+        while( 1 ){
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                job_ready.wait(lock, [this]{ return stopped || !jobs.empty(); });
+                if( jobs.empty() ) return;
+
+                job = jobs.front();
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    bool stopped;
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    std::deque<std::function<void()>> jobs;
+    std::vector<std::thread> workers;
+};
+
+// ClientSession: one connection and its incremental solver
+class ClientSession {
+public:
+    ClientSession(int fd, WorkerPool& pool) : fd(fd), pool(pool), peer_closed(false), has_new_clause(false) {}
+    ~ClientSession(){ close(fd); }
+
+    void run();
+
+private:
+    bool read_more(int timeout_ms);
+    bool next_line(std::string& line);
+    void take_cancel_lines(std::atomic<bool>& cancel);
+    bool handle_line(const std::string& line);
+    bool add_cardinality(const std::string& line);
+    void solve(long long time_ms, long long conflict_budget);
+    void send_text(const std::string& text);
+
+    int fd;
+    WorkerPool& pool;
+    std::string read_buffer;
+    bool peer_closed;
+    bool has_new_clause;
+    SatSolver solver;
+};
+
+void ClientSession::run(){
+    std::string line;
+    while( 1 ){
+        while( next_line(line) ){
+            if( !handle_line(line) ) return;
+        }
+        if( peer_closed ){
+            // last line without '\n'
+            if( !read_buffer.empty() ){
+                line.swap(read_buffer);
+                read_buffer.clear();
+                if( !handle_line(line) ) return;
+            }
+            if( has_new_clause ){
+                solve(0, 0);
+            }
+            return;
+        }
+        if( server_stop ) return;
+        read_more(200);
+    }
+}
+
+bool ClientSession::read_more(int timeout_ms){
+    /* read available data into read_buffer, return true if any data is read */
+    pollfd poll_fd = {fd, POLLIN, 0};
+    if( poll(&poll_fd, 1, timeout_ms) <= 0 ) return false;
+
+    char buf[65536];
+    ssize_t size = recv(fd, buf, sizeof(buf), 0);
+    if( size <= 0 ){
+        peer_closed = true;
+        return false;
+    }
+    read_buffer.append(buf, size);
+    return true;
+}
+
+bool ClientSession::next_line(std::string& line){
+    std::size_t end = read_buffer.find('\n');
+    if( end == std::string::npos ) return false;
+
+    line = read_buffer.substr(0, end);
+    read_buffer.erase(0, end + 1);
+    return true;
+}
+
+void ClientSession::take_cancel_lines(std::atomic<bool>& cancel){
+    /* remove `cancel' lines from read_buffer, keep other pipelined lines */
+    std::string rest;
+    std::size_t begin = 0, end;
+    while( (end = read_buffer.find('\n', begin)) != std::string::npos ){
+        std::string line = read_buffer.substr(begin, end - begin);
+        if( line == "cancel" || line == "cancel\r" ){
+            cancel = true;
+        }
+        else{
+            rest += line + "\n";
+        }
+        begin = end + 1;
+    }
+    rest += read_buffer.substr(begin);
+    read_buffer.swap(rest);
+}
+
+static bool parse_lit(const std::string& token, int& lit){
+    /* whole token is a literal: nonzero integer, |lit| <= max_session_var */
+    char* end = nullptr;
+    errno = 0;
+    long value = std::strtol(token.c_str(), &end, 10);
+    if( errno != 0 || end == token.c_str() || *end != '\0' ) return false;
+    if( value == 0 || value > max_session_var || value < -max_session_var ) return false;
+    lit = value;
+    return true;
+}
+
+static bool parse_budget(const std::string& token, long long& budget){
+    /* whole token is a nonnegative integer */
+    char* end = nullptr;
+    errno = 0;
+    long long value = std::strtoll(token.c_str(), &end, 10);
+    if( errno != 0 || end == token.c_str() || *end != '\0' || value < 0 ) return false;
+    budget = value;
+    return true;
+}
+
+static bool parse_lits(std::istringstream& tokens, std::vector<int>& lits){
+    /* rest of the line as DIMACS literals, 0 terminates a clause */
+    std::string token;
+    while( tokens >> token ){
+        int lit;
+        if( token == "0" ) lits.push_back(0);
+        else if( parse_lit(token, lit) ) lits.push_back(lit);
+        else return false;
+    }
+    return true;
+}
+
+bool ClientSession::handle_line(const std::string& line){
+    /* return false if session is closed */
+    std::istringstream tokens(line);
+    std::string command;
+    if( !(tokens >> command) ) return true;
+
+    if( command == "c" || command == "cancel" ){
+        // comment, or cancel with no running solve
+    }
+    else if( command == "p" || command == "reset" ){
+        solver = SatSolver();
+        has_new_clause = false;
+    }
+    else if( command == "a" ){
+        std::vector<int> lits;
+        if( !parse_lits(tokens, lits) ){
+            send_text("c invalid assumptions: " + line + "\n");
+            return true;
+        }
+        for( auto lit : lits ){
+            if( lit == 0 ) break;
+            solver.assume(lit);
+        }
+    }
+    else if( command[0] == '-' || (command[0] >= '0' && command[0] <= '9') ){
+        if( line.find_first_of("<>") != std::string::npos ){
+            if( add_cardinality(line) ) has_new_clause = true;
+            return true;
+        }
+
+        // a clause can span lines, an invalid line adds none of its literals
+        tokens.str(line);
+        tokens.clear();
+        std::vector<int> lits;
+        if( !parse_lits(tokens, lits) ){
+            send_text("c invalid clause: " + line + "\n");
+            return true;
+        }
+        for( auto lit : lits ){
+            solver.add_lit(lit);
+        }
+        has_new_clause = true;
+    }
+    else if( command == "solve" ){
+        // `solve [time_ms] [conflicts]', both nonnegative integers
+        long long budgets[2] = { 0, 0 };
+        std::string token;
+        int budget_count = 0;
+        while( tokens >> token ){
+            if( budget_count == 2 || !parse_budget(token, budgets[budget_count]) ){
+                send_text("c invalid solve arguments: " + line + "\n");
+                return true;
+            }
+            budget_count += 1;
+        }
+        solve(budgets[0], budgets[1]);
+    }
+    else if( command == "quit" ){
+        return false;
+    }
+    else{
+        send_text("c unknown command: " + command + "\n");
+    }
+    return true;
+}
+
+bool ClientSession::add_cardinality(const std::string& line){
+    /* `<lits> <= k' or `<lits> >= k', return false (and reply) if the line is invalid */
+    std::istringstream tokens(line);
+    std::vector<int> lits;
+    std::string token, relation;
+    while( tokens >> token ){
+        if( token == "<=" || token == ">=" ){
+            relation = token;
+            break;
+        }
+        int lit;
+        if( !parse_lit(token, lit) ) break;
+        lits.push_back(lit);
+    }
+
+    // the bound must be an integer and the last token
+    std::string bound_token, rest;
+    char* end = nullptr;
+    long bound = 0;
+    if( !relation.empty() && tokens >> bound_token && !(tokens >> rest) ){
+        errno = 0;
+        bound = std::strtol(bound_token.c_str(), &end, 10);
+    }
+    if( relation.empty() || end == nullptr || end == bound_token.c_str() || *end != '\0' ||
+        errno != 0 || bound < -max_session_var || bound > max_session_var ){
+        send_text("c invalid cardinality constraint: " + line + "\n");
+        return false;
+    }
+
+    if( relation == "<=" ) solver.add_at_most(lits, bound);
+    else solver.add_at_least(lits, bound);
+    return true;
+}
+
+void ClientSession::solve(long long time_ms, long long conflict_budget){
+    TRACE_SCOPE("session_solve");
+    std::atomic<bool> cancel(false);
+    solver.set_terminate_flag(&cancel);
+    solver.set_conflict_budget(conflict_budget > 0 ? conflict_budget : -1);
+
+    // the job owns its task, it may still run after this frame is left
+    auto job = std::make_shared<std::packaged_task<BoolVal()>>([this]{ return solver.solve_limited(); });
+    std::future<BoolVal> result = job->get_future();
+    pool.submit([job]{ (*job)(); });
+
+    // wait result, watch cancel, client disconnect and time budget
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(time_ms);
+    while( result.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready ){
+        if( !peer_closed ){
+            read_more(10);
+            take_cancel_lines(cancel);
+        }
+        else{
+            result.wait_for(std::chrono::milliseconds(10));
+        }
+
+        if( time_ms > 0 && std::chrono::steady_clock::now() > deadline ) cancel = true;
+        if( server_stop ) cancel = true;
+    }
+    BoolVal is_sat = result.get();
+    solver.set_terminate_flag(nullptr);
+    has_new_clause = false;
+
+    std::ostringstream output_stream;
+    if( is_sat == BoolVal::TRUE ){
+        output_stream << "s SATISFIABLE" << std::endl;
+        print_sat_solution(output_stream, solver.answer());
+    }
+    else if( is_sat == BoolVal::FALSE ){
+        output_stream << "s UNSATISFIABLE" << std::endl;
+    }
+    else{
+        output_stream << "s UNKNOWN" << std::endl;
+    }
+    send_text(output_stream.str());
+}
+
+void ClientSession::send_text(const std::string& text){
+    std::size_t sent = 0;
+    while( sent < text.size() ){
+        ssize_t size = send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if( size <= 0 ) return;
+        sent += size;
+    }
+}
+
+static void handle_client(int fd, WorkerPool* pool){
+    trace_thread_name("session");
+    {
+        ClientSession session(fd, *pool);
+        session.run();
+    }
+    session_count -= 1;
+}
+
+int serve(const std::string& socket_path, int worker_count){
+    sockaddr_un address;
+    if( socket_path.size() >= sizeof(address.sun_path) ){
+        std::cerr << "socket path is too long: " << socket_path << std::endl;
+        return 1;
+    }
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if( listen_fd < 0 ){
+        std::cerr << "socket() failed: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, socket_path.c_str());
+    unlink(socket_path.c_str());
+
+    if( bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, 64) < 0 ){
+        std::cerr << "can't listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        return 1;
+    }
+
+    std::signal(SIGINT, stop_server);
+    std::signal(SIGTERM, stop_server);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cerr << "c yasat serving on " << socket_path
+              << " with " << worker_count << " workers" << std::endl;
+
+    {
+        WorkerPool pool(worker_count > 0 ? worker_count : 1);
+
+        while( !server_stop ){
+            pollfd poll_fd = {listen_fd, POLLIN, 0};
+            if( poll(&poll_fd, 1, 200) <= 0 ) continue;
+
+            int client_fd = accept(listen_fd, nullptr, nullptr);
+            if( client_fd < 0 ) continue;
+
+            session_count += 1;
+            std::thread(handle_client, client_fd, &pool).detach();
+        }
+
+        // running solves see server_stop and return UNKNOWN
+        while( session_count > 0 ){
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    return 0;
+}
@@ -0,0 +1,36 @@
+#ifndef __SERVER_H__
+#define __SERVER_H__
+
+#include <string>
+
+// solver daemon over unix domain socket
+//
+// each client connection is one session with its own incremental SatSolver,
+// and solve requests of all sessions run on a pool of worker threads.
+//
+// line based protocol, client -> server:
+//
+//   c ...                        comment, ignored
+//   p cnf <vars> <clauses>       start a new problem (reset session)
+//   <lit> <lit> ... 0            DIMACS clause, can span lines
+//   <lit> ... <= k / >= k        cardinality constraint, one line
+//   a <lit> <lit> ... 0          assumptions for next solve only
+//   solve [time_ms] [conflicts]  solve with budget, nonnegative integers, 0 means no limit
+//   cancel                       cancel running solve of this session
+//   reset                        drop all clauses of this session
+//   quit                         close session
+//
+// server -> client, same as yasat output:
+//
+//   s SATISFIABLE / s UNSATISFIABLE / s UNKNOWN
+//   v ... 0                      (only when SATISFIABLE)
+//   c invalid ... / c unknown command: ...   line is rejected and ignored
+//
+// literals are nonzero integers up to 2^30 - 1 in absolute value.
+//
+// if the client closes its write side after sending clauses without `solve',
+// server solves them once and replies before closing.
+
+int serve(const std::string& socket_path, int worker_count);
+
+#endif /* end of include guard: __SERVER_H__ */
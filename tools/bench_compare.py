@@ -0,0 +1,32 @@
+#!/usr/bin/env python3
+
+# compare two outputs of yasat_bench
+#
+#   ./yasat_bench > old.json; (change code); ./yasat_bench > new.json
+#   ./bench_compare.py old.json new.json
+
+import json
+import sys
+
+def load(bench_file):
+    return { result['kernel']: result for result in map(json.loads, bench_file) if result }
+
+def main():
+    if len(sys.argv) != 3:
+        print('invalid number of arguments')
+        print('./{} <old.json> <new.json>'.format(sys.argv[0]))
+        sys.exit(1)
+
+    with open(sys.argv[1]) as old_file, open(sys.argv[2]) as new_file:
+        old, new = load(old_file), load(new_file)
+
+    print('{:<30} {:>14} {:>14} {:>9}  {}'.format('kernel', 'old median', 'new median', 'change', 'unit'))
+    for kernel in old:
+        if kernel not in new:
+            continue
+        old_median, new_median = old[kernel]['median'], new[kernel]['median']
+        change = (new_median - old_median) / old_median * 100
+        print('{:<30} {:>14.4g} {:>14.4g} {:>+8.1f}%  {}'.format(
+            kernel, old_median, new_median, change, new[kernel]['unit']))
+
+main()
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+
+# Regression tests of yasat, `make test' or
+#   python3 tools/regression_test.py [./yasat]
+#
+# each case is a list of runs in one temporary directory, which share the
+# result cache of the case. a run writes its formula to <name>.cnf (and
+# answer to <name>.sat for --verify), runs yasat and checks the `s' line
+# (and the exit status). `cache_entry' replaces the cached result of the
+# run (needs --stats for the cache key) to check what a later run trusts.
+
+import os
+import subprocess
+import sys
+import tempfile
+
+CASES = [
+    ('cache: repeated cardinality literal counts twice', [
+        { 'name': 'twice', 'cnf': 'p cnf 1 2\n1 1 <= 1\n1 0\n',
+          'args': ['--cache', 'cache'], 'expect': 's UNSATISFIABLE' },
+        { 'name': 'once', 'cnf': 'p cnf 1 2\n1 <= 1\n1 0\n',
+          'args': ['--cache', 'cache'], 'expect': 's SATISFIABLE' },
+    ]),
+    ('cache: negative cardinality bound is not a clause', [
+        { 'name': 'atleast', 'cnf': 'p cnf 2 1\n1 2 >= 3\n',
+          'args': ['--cache', 'cache'], 'expect': 's UNSATISFIABLE' },
+        { 'name': 'clause', 'cnf': 'p cnf 2 1\n-1 -2 0\n',
+          'args': ['--cache', 'cache'], 'expect': 's SATISFIABLE' },
+    ]),
+    ('verify: model with x and -x', [
+        { 'name': 'unsat', 'cnf': 'p cnf 2 4\n1 2 0\n-1 2 0\n1 -2 0\n-1 -2 0\n',
+          'answer': 's SATISFIABLE\nv 1 -1 2 -2 0\n',
+          'args': ['--verify', '{cnf}', 'unsat.sat'], 'expect': 'c verify = FAILED', 'status': 2 },
+    ]),
+    ('verify: model variable beyond the formula', [
+        { 'name': 'range', 'cnf': 'p cnf 2 1\n1 2 0\n',
+          'answer': 's SATISFIABLE\nv 1 2 3 0\n',
+          'args': ['--verify', '{cnf}', 'range.sat'], 'expect': 'c verify = FAILED', 'status': 2 },
+        { 'name': 'header', 'cnf': 'p cnf 3 1\n1 2 0\n',
+          'answer': 's SATISFIABLE\nv 1 2 3 0\n',
+          'args': ['--verify', '{cnf}', 'header.sat'], 'expect': 'c verify = OK', 'status': 0 },
+    ]),
+    ('cache: cached model with x and -x is not reused', [
+        { 'name': 'unsat', 'cnf': 'p cnf 2 4\n1 2 0\n-1 2 0\n1 -2 0\n-1 -2 0\n',
+          'args': ['--stats', '--cache', 'cache'], 'expect': 's UNSATISFIABLE',
+          'cache_entry': 's SATISFIABLE\nv 1 -1 2 -2 0\n' },
+        { 'name': 'unsat', 'cnf': 'p cnf 2 4\n1 2 0\n-1 2 0\n1 -2 0\n-1 -2 0\n',
+          'args': ['--stats', '--cache', 'cache'], 'expect': 'c cache_hit = 0' },
+    ]),
+    ('count: header variables in no clause are free', [
+        { 'name': 'free', 'cnf': 'p cnf 3 1\n1 2 0\n', 'args': ['--count'], 'expect': 's mc 6' },
+        { 'name': 'project', 'cnf': 'p cnf 3 1\n1 2 0\n', 'args': ['--count', '--project', '1,3'], 'expect': 's mc 4' },
+        { 'name': 'beyond', 'cnf': 'p cnf 2 1\n1 2 0\n', 'args': ['--count', '--project', '1,3'], 'expect': 's mc 4' },
+    ]),
+]
+
+def run(yasat, directory, step):
+    cnf_path = os.path.join(directory, step['name'] + '.cnf')
+    with open(cnf_path, 'w') as cnf_file:
+        cnf_file.write(step['cnf'])
+    if 'answer' in step:
+        with open(os.path.join(directory, step['name'] + '.sat'), 'w') as answer_file:
+            answer_file.write(step['answer'])
+
+    args = [arg if arg != '{cnf}' else cnf_path for arg in step['args']]
+    if '{cnf}' not in step['args']:
+        args.append(cnf_path)
+    process = subprocess.run([yasat] + args, cwd=directory, stdout=subprocess.PIPE,
+                             stderr=subprocess.PIPE, universal_newlines=True)
+
+    # DEBUG builds print the answer, others write it next to the formula
+    output = process.stdout
+    sat_path = os.path.join(directory, step['name'] + '.sat')
+    if not any(line.startswith('s ') for line in output.splitlines()) and \
+       'answer' not in step and os.path.exists(sat_path):
+        with open(sat_path) as sat_file:
+            output += sat_file.read()
+
+    lines = output.splitlines() + process.stderr.splitlines()
+    if step['expect'] not in lines:
+        return 'expected "{}", got:\n{}'.format(step['expect'], output + process.stderr)
+    if 'status' in step and process.returncode != step['status']:
+        return 'expected exit status {}, got {}'.format(step['status'], process.returncode)
+
+    if 'cache_entry' in step:
+        keys = [line.split()[-1] for line in process.stderr.splitlines() if line.startswith('c cache_key = ')]
+        if not keys:
+            return 'no cache key, run with --stats'
+        with open(os.path.join(directory, 'cache', keys[0] + '.sat'), 'w') as entry_file:
+            entry_file.write(step['cache_entry'])
+    return None
+
+def main():
+    yasat = os.path.abspath(sys.argv[1] if len(sys.argv) > 1 else './yasat')
+
+    failed = 0
+    for case_name, steps in CASES:
+        with tempfile.TemporaryDirectory() as directory:
+            for step in steps:
+                error = run(yasat, directory, step)
+                if error is not None:
+                    print('FAILED {} ({}): {}'.format(case_name, step['name'], error))
+                    failed += 1
+                    break
+            else:
+                print('ok     {}'.format(case_name))
+
+    print('{} of {} cases failed'.format(failed, len(CASES)))
+    sys.exit(1 if failed else 0)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+
+# scaling study: generate instances of growing size by yasat_gen,
+# run `yasat --stats' on them and print one CSV row per instance.
+#
+#   ./scaling_bench.py [--family random] [--sizes 10000 100000 ...] [--conflicts 1000]
+#
+# sizes are --vars of random/planted (clause/variable ratio by --ratio),
+# --size of parity and --holes of php.
+# run from the repo root after `make && make gen'.
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+FIELDS = ['family', 'size', 'variables', 'clauses', 'file_mb', 'parse_seconds', 'solve_seconds',
+          'propagations', 'propagations_per_second', 'max_rss_kb']
+
+def gen_args(args, size):
+    if args.family in ('random', 'planted'):
+        return [args.family, '--vars', str(size), '--ratio', str(args.ratio), '--k', str(args.k)]
+    if args.family == 'parity':
+        return ['parity', '--size', str(size)]
+    return ['php', '--holes', str(size)]
+
+def run_size(args, size, workdir):
+    cnf_name = os.path.join(workdir, '{}_{}.cnf'.format(args.family, size))
+    subprocess.check_call([args.gen] + gen_args(args, size) + ['--seed', str(args.seed), '-o', cnf_name])
+
+    solver = subprocess.run([args.yasat, '--stats', '--conflicts', str(args.conflicts), cnf_name],
+                            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, universal_newlines=True)
+    stats = dict(re.findall(r'^c (\w+) = (\S+)$', solver.stderr, re.MULTILINE))
+
+    row = { 'family': args.family, 'size': size, 'file_mb': '{:.2f}'.format(os.path.getsize(cnf_name) / 1e6) }
+    row.update(stats)
+
+    os.remove(cnf_name)
+    for sat_name in (cnf_name[:-4] + '.sat',):
+        if os.path.exists(sat_name):
+            os.remove(sat_name)
+    return row
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--family', default='random', choices=['random', 'planted', 'parity', 'php'])
+    parser.add_argument('--sizes', type=int, nargs='+', default=[10000, 100000, 1000000])
+    parser.add_argument('--ratio', type=float, default=4.26)
+    parser.add_argument('--k', type=int, default=3)
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--conflicts', type=int, default=1000, help='conflict budget of each solve')
+    parser.add_argument('--yasat', default='./yasat')
+    parser.add_argument('--gen', default='./yasat_gen')
+    parser.add_argument('--workdir', default=None, help='directory of generated instances')
+    args = parser.parse_args()
+
+    workdir = args.workdir or tempfile.mkdtemp(prefix='yasat_scaling_')
+
+    print(','.join(FIELDS))
+    for size in args.sizes:
+        row = run_size(args, size, workdir)
+        print(','.join(str(row.get(field, '')) for field in FIELDS))
+        sys.stdout.flush()
+
+    if args.workdir is None:
+        os.rmdir(workdir)
+
+main()
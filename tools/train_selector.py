@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+
+# train the table of `yasat --auto' (see config_selector.h)
+#
+#   ./train_selector.py <dir or cnf> ... [--configs dpll dpll-amo lookahead] [--timeout 10]
+#                       [--repeat 5] [--margin 1.5] [--min-seconds 0.01] [--inc]
+#
+# every configuration is run `repeat' times on every instance (median of the reported solve_seconds),
+# and one table row `<config> <features ...>' is printed per instance. The label is the first
+# (default) config unless another one is faster by `margin' times and `min-seconds',
+# so instances solved in milliseconds don't get noise labels.
+# --inc prints the table as C string literal lines for selector_table.inc.
+# run from the repo root after `make'.
+
+import argparse
+import os
+import re
+import statistics
+import subprocess
+
+def find_cnf(paths):
+    for path in paths:
+        if os.path.isfile(path):
+            yield path
+            continue
+        for root, dirs, files in os.walk(path):
+            dirs.sort()
+            for name in sorted(files):
+                if name.endswith('.cnf'):
+                    yield os.path.join(root, name)
+
+def features(yasat, cnf_name):
+    solver = subprocess.run([yasat, '--features', '--conflicts', '0', cnf_name],
+                            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, universal_newlines=True)
+    return re.findall(r'^c feature_\w+ = (\S+)$', solver.stderr, re.MULTILINE)
+
+def solve_seconds(yasat, config, cnf_name, timeout, repeat):
+    # median of `c solve_seconds' (no process start and parsing), a timeout stops the repeats
+    times = []
+    for _ in range(repeat):
+        try:
+            solver = subprocess.run([yasat, '--stats', '--config', config, cnf_name], stdout=subprocess.DEVNULL,
+                                    stderr=subprocess.PIPE, universal_newlines=True, timeout=timeout)
+        except subprocess.TimeoutExpired:
+            return float('inf')
+        match = re.search(r'^c solve_seconds = (\S+)$', solver.stderr, re.MULTILINE)
+        if match is None:
+            return float('inf')
+        times.append(float(match.group(1)))
+    return statistics.median(times)
+
+def label(configs, times, margin, min_seconds):
+    # the first config is the default, another one must win by `margin' times and `min_seconds'
+    default = configs[0]
+    best = min(configs, key=lambda config: times[config])
+    if times[best] * margin < times[default] and times[default] - times[best] > min_seconds:
+        return best
+    return default if times[default] != float('inf') else None
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('paths', nargs='+')
+    parser.add_argument('--configs', nargs='+', default=['dpll', 'dpll-amo', 'lookahead'])
+    parser.add_argument('--timeout', type=float, default=10)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--margin', type=float, default=1.5, help='speedup needed over the default config')
+    parser.add_argument('--min-seconds', type=float, default=0.01, help='time saving needed over the default config')
+    parser.add_argument('--yasat', default='./yasat')
+    parser.add_argument('--inc', action='store_true', help='print as C string literal lines')
+    args = parser.parse_args()
+
+    for cnf_name in find_cnf(args.paths):
+        times = { config: solve_seconds(args.yasat, config, cnf_name, args.timeout, args.repeat)
+                  for config in args.configs }
+        best = label(args.configs, times, args.margin, args.min_seconds)
+        if best is None:
+            continue
+
+        row = '{} {}'.format(best, ' '.join(features(args.yasat, cnf_name)))
+        if args.inc:
+            print('"{}\\n" // {}'.format(row, os.path.basename(cnf_name)))
+        else:
+            print(row)
+
+main()
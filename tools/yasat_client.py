@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+
+# client of `yasat --serve <socket>'
+#
+#   ./yasat_client.py <socket> <problem.cnf> [-a lit ...] [-t time_ms] [-b conflicts]
+
+import argparse
+import socket
+import sys
+
+def read_result(sock_file):
+    ''' read `s ...' line and `v ... 0' line if SATISFIABLE '''
+
+    lines = []
+    while True:
+        line = sock_file.readline()
+        if not line:
+            break
+        lines.append(line)
+
+        if line.startswith('s '):
+            if not line.startswith('s SATISFIABLE'):
+                break
+        elif line.startswith('v ') and line.split()[-1] == '0':
+            break
+
+    return ''.join(lines)
+
+def solve(socket_path, problem, assumptions, time_ms, conflicts):
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(socket_path)
+    sock_file = sock.makefile('rw')
+
+    sock_file.write(problem)
+    if not problem.endswith('\n'):
+        sock_file.write('\n')
+    if assumptions:
+        sock_file.write('a {} 0\n'.format(' '.join(str(lit) for lit in assumptions)))
+    sock_file.write('solve {} {}\n'.format(time_ms, conflicts))
+    sock_file.flush()
+
+    result = read_result(sock_file)
+
+    sock_file.write('quit\n')
+    sock_file.flush()
+    sock.close()
+    return result
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('socket')
+    parser.add_argument('problem')
+    parser.add_argument('-a', '--assume', type=int, nargs='*', default=[])
+    parser.add_argument('-t', '--time', type=int, default=0, help='time budget in ms, 0 is no limit')
+    parser.add_argument('-b', '--conflicts', type=int, default=0, help='conflict budget, 0 is no limit')
+    args = parser.parse_args()
+
+    with open(args.problem, 'r') as problem_file:
+        problem = problem_file.read()
+
+    sys.stdout.write(solve(args.socket, problem, args.assume, args.time, args.conflicts))
+
+main()
@@ -0,0 +1,126 @@
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+
+#include "trace.h"
+
+bool trace_enabled = false;
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    long long start_ns;
+    long long end_ns;
+};
+
+// ring buffer of one thread, only the owner thread writes it
+struct TraceBuffer {
+    int tid;
+    std::string thread_name;
+    std::vector<TraceEvent> events;
+    long long recorded;
+};
+
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<TraceBuffer>> registry;  // buffers outlive their threads
+std::string trace_path;
+int buffer_size = 0;
+long long trace_origin_ns = 0;
+bool dumped = false;
+
+thread_local TraceBuffer* thread_buffer = nullptr;
+
+TraceBuffer& current_buffer(){
+    if( thread_buffer == nullptr ){
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.emplace_back(new TraceBuffer());
+        thread_buffer = registry.back().get();
+        thread_buffer->tid = registry.size();
+        thread_buffer->events.resize(buffer_size);
+        thread_buffer->recorded = 0;
+    }
+    return *thread_buffer;
+}
+
+void dump_at_exit(){
+    trace_dump();
+}
+
+}
+
+void trace_start(const std::string& path, int events_per_thread){
+    trace_path = path;
+    buffer_size = events_per_thread > 0 ? events_per_thread : 1;
+    trace_origin_ns = trace_now_ns();
+    if( !trace_enabled ){
+        std::atexit(dump_at_exit);
+    }
+    trace_enabled = true;
+    trace_thread_name("main");
+}
+
+void trace_thread_name(const std::string& name){
+    if( !trace_enabled ) return;
+    current_buffer().thread_name = name;
+}
+
+void trace_record(const char* name, long long start_ns, long long end_ns){
+    TraceBuffer& buffer = current_buffer();
+    buffer.events[buffer.recorded % buffer_size] = { name, start_ns, end_ns };
+    buffer.recorded += 1;
+}
+
+void trace_dump(){
+    /*
+     * write all buffers as trace-event JSON, once.
+     * traced threads should be finished or idle, their buffers are read without lock.
+     *
+     *   {"traceEvents": [
+     *     {"name": "thread_name", "ph": "M", "pid": P, "tid": T, "args": {"name": "main"}},
+     *     {"name": "parse", "ph": "X", "pid": P, "tid": T, "ts": <us>, "dur": <us>},
+     *     ...
+     *   ], "displayTimeUnit": "ms"}
+     */
+    if( !trace_enabled || dumped ) return;
+    dumped = true;
+
+    FILE *out = std::fopen(trace_path.c_str(), "w");
+    if( out == NULL ){
+        std::fprintf(stderr, "ERROR! Could not open file: %s\n", trace_path.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    int pid = getpid();
+    const char* separator = "\n";
+    std::fprintf(out, "{\"traceEvents\": [");
+    for( const auto& buffer : registry ){
+        if( !buffer->thread_name.empty() ){
+            std::fprintf(out, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, "
+                              "\"args\": {\"name\": \"%s\"}}",
+                         separator, pid, buffer->tid, buffer->thread_name.c_str());
+            separator = ",\n";
+        }
+
+        // oldest event first, events older than the ring are overwritten
+        long long first = buffer->recorded > buffer_size ? buffer->recorded - buffer_size : 0;
+        for( long long i = first; i < buffer->recorded; i++ ){
+            const TraceEvent& event = buffer->events[i % buffer_size];
+            std::fprintf(out, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": %d, "
+                              "\"ts\": %.3f, \"dur\": %.3f}",
+                         separator, event.name, pid, buffer->tid,
+                         (event.start_ns - trace_origin_ns) / 1e3, (event.end_ns - event.start_ns) / 1e3);
+            separator = ",\n";
+        }
+        if( first > 0 ){
+            std::fprintf(stderr, "c trace: %lld oldest events of thread %d are dropped\n", first, buffer->tid);
+        }
+    }
+    std::fprintf(out, "\n], \"displayTimeUnit\": \"ms\"}\n");
+    std::fclose(out);
+}
@@ -0,0 +1,57 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <chrono>
+#include <string>
+
+// phase timeline tracing, Chrome trace-event JSON (loads in Perfetto / chrome://tracing)
+//
+//   trace_start("trace.json");          // before any traced thread starts
+//   {
+//       TRACE_SCOPE("parse");           // one complete event for this scope
+//       ...
+//   }
+//   // file is written by trace_dump(), called at exit by trace_start()
+//
+// every thread records into its own ring buffer of the last `events_per_thread'
+// events, no lock on the recording path. Event names must be string literals.
+//
+// when tracing is not started, a scope is one branch on `trace_enabled',
+// and -DYASAT_NO_TRACE removes TRACE_SCOPE from the build completely.
+
+extern bool trace_enabled;
+
+void trace_start(const std::string& path, int events_per_thread = 65536);
+void trace_thread_name(const std::string& name);
+void trace_record(const char* name, long long start_ns, long long end_ns);
+void trace_dump();
+
+inline long long trace_now_ns(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), start_ns(trace_enabled ? trace_now_ns() : -1) {}
+    ~TraceScope(){
+        if( start_ns >= 0 ) trace_record(name, start_ns, trace_now_ns());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator = (const TraceScope&) = delete;
+
+private:
+    const char* name;
+    long long start_ns;
+};
+
+#ifdef YASAT_NO_TRACE
+#define TRACE_SCOPE(name)
+#else
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#endif
+
+#endif /* end of include guard: __TRACE_H__ */
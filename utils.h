@@ -7,5 +7,14 @@
 template <class T> using vector_2d = std::vector< std::vector<T> >; 
 template <class T> using vector_3d = std::vector< vector_2d<T> >;
 
+/* cardinality constraint: at most `bound' literals of `lits' are true */
+struct CardinalityConstraint {
+    std::vector<int> lits;
+    int bound;
+
+    CardinalityConstraint() : bound(0) {}
+    CardinalityConstraint(const std::vector<int>& lits, int bound) : lits(lits), bound(bound) {}
+};
+
 #endif /* end of include guard: __UTILS_H__ */
 
@@ -0,0 +1,46 @@
+#include <cstdlib>
+
+#include "yasat.h"
+#include "sat_solver.h"
+
+struct yasat {
+    SatSolver solver;
+};
+
+yasat_t* yasat_new(void){
+    return new yasat;
+}
+
+void yasat_delete(yasat_t *solver){
+    delete solver;
+}
+
+void yasat_add(yasat_t *solver, int lit){
+    solver->solver.add_lit(lit);
+}
+
+void yasat_add_at_most(yasat_t *solver, const int *lits, int size, int bound){
+    solver->solver.add_at_most(std::vector<int>(lits, lits + size), bound);
+}
+
+void yasat_add_at_least(yasat_t *solver, const int *lits, int size, int bound){
+    solver->solver.add_at_least(std::vector<int>(lits, lits + size), bound);
+}
+
+int yasat_solve(yasat_t *solver){
+    return solver->solver.solve() ? YASAT_SAT : YASAT_UNSAT;
+}
+
+int yasat_val(yasat_t *solver, int lit){
+    int lit_num = std::abs(lit);
+    if( lit_num > solver->solver.num_vars() ) return 0;
+
+    BoolVal value = solver->solver.value(lit_num);
+    if( value == BoolVal::NOT_ASSIGNED ) return 0;
+    if( (value == BoolVal::TRUE) == (lit > 0) ) return lit;
+    return -lit;
+}
+
+int yasat_max_var(yasat_t *solver){
+    return solver->solver.num_vars();
+}
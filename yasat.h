@@ -0,0 +1,45 @@
+#ifndef __YASAT_H__
+#define __YASAT_H__
+
+/* C API of YaSAT library.
+ *
+ *   yasat_t *solver = yasat_new();
+ *
+ *   // add clause (x1 or -x2), 0 terminates the clause
+ *   yasat_add(solver, 1); yasat_add(solver, -2); yasat_add(solver, 0);
+ *
+ *   if( yasat_solve(solver) == YASAT_SAT ){
+ *       int value_of_x1 = yasat_val(solver, 1); // 1 or -1
+ *   }
+ *   yasat_delete(solver);
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YASAT_SAT   10
+#define YASAT_UNSAT 20
+
+typedef struct yasat yasat_t;
+
+yasat_t* yasat_new(void);
+void yasat_delete(yasat_t *solver);
+
+void yasat_add(yasat_t *solver, int lit);
+
+/* at most / at least `bound' of lits[0 .. size-1] are true */
+void yasat_add_at_most(yasat_t *solver, const int *lits, int size, int bound);
+void yasat_add_at_least(yasat_t *solver, const int *lits, int size, int bound);
+
+int yasat_solve(yasat_t *solver);
+
+/* return lit if lit is true, -lit if lit is false, 0 if not assigned */
+int yasat_val(yasat_t *solver, int lit);
+int yasat_max_var(yasat_t *solver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of include guard: __YASAT_H__ */